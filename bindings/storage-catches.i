@@ -233,5 +233,6 @@
 %catches(storage::Exception) storage::Storage::get_devicegraph(const std::string &name) const;
 %catches(storage::Exception) storage::Storage::probe();
 %catches(storage::Exception) storage::Storage::remove_devicegraph(const std::string &name);
+%catches(storage::Exception) storage::Storage::reprobe();
 %catches(storage::Exception) storage::Storage::restore_devicegraph(const std::string &name);
 
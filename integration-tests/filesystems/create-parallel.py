@@ -0,0 +1,31 @@
+#!/usr/bin/python3
+
+# requirements: disks /dev/sdb, /dev/sdc, /dev/sdd and /dev/sde with msdos
+# partition table and partition /dev/sd[b-e]1
+
+
+from storage import *
+from storageitu import *
+
+
+set_logger(get_logfile_logger())
+
+environment = Environment(False)
+
+storage = Storage(environment)
+storage.probe()
+
+staging = storage.get_staging()
+
+print(staging)
+
+for name in ["/dev/sdb1", "/dev/sdc1", "/dev/sdd1", "/dev/sde1"]:
+
+    partition = Partition.find_by_name(staging, name)
+    partition.set_id(ID_LINUX)
+
+    ext4 = partition.create_blk_filesystem(FsType_EXT4)
+
+print(staging)
+
+commit(storage, num_threads = 4)
@@ -37,7 +37,7 @@ class MyCommitCallbacks(CommitCallbacks):
 
 
 def commit(storage, skip_save_graphs = True, skip_print_actiongraph = True,
-           skip_commit = False):
+           skip_commit = False, num_threads = 1):
 
     if not skip_save_graphs:
         storage.get_probed().save("probed.xml")
@@ -66,4 +66,5 @@ def commit(storage, skip_save_graphs = True, skip_print_actiongraph = True,
         system("dot -Tsvg < action.gv > action.svg")
 
     if not skip_commit:
-        storage.commit(my_commit_callbacks)
+        commit_options = CommitOptions(False, num_threads)
+        storage.commit(commit_options, my_commit_callbacks)
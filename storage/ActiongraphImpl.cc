@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -28,11 +28,16 @@
 #include <boost/graph/graphviz.hpp>
 
 #include "storage/Utils/Stopwatch.h"
+#include "storage/Utils/ThreadPool.h"
 #include "storage/Devices/DeviceImpl.h"
 #include "storage/Devices/BlkDevice.h"
 #include "storage/Devices/PartitionTableImpl.h"
+#include "storage/Devices/PartitionImpl.h"
+#include "storage/Devices/Partitionable.h"
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
+#include "storage/Filesystems/BtrfsSubvolumeImpl.h"
+#include "storage/Filesystems/Btrfs.h"
 #include "storage/Devicegraph.h"
 #include "storage/Utils/GraphUtils.h"
 #include "storage/Action.h"
@@ -165,7 +170,7 @@ namespace storage
     Actiongraph::Impl::vertex_descriptor
     Actiongraph::Impl::add_vertex(Action::Base* action)
     {
-	return boost::add_vertex(shared_ptr<Action::Base>(action), graph);
+	return boost::add_vertex(vertex_property_t(num_actions(), shared_ptr<Action::Base>(action)), graph);
     }
 
 
@@ -471,18 +476,23 @@ namespace storage
 	    clear_vertex(vertex, graph);
 	    remove_vertex(vertex, graph);
 	}
+
+	if (!only_syncs.empty())
+	{
+	    size_t index = 0;
+
+	    for (vertex_descriptor vertex : vertices())
+		boost::put(boost::vertex_index, graph, vertex, index++);
+	}
     }
 
 
     void
     Actiongraph::Impl::calculate_order()
     {
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	try
 	{
-	    boost::topological_sort(graph, front_inserter(order),
-				    vertex_index_map(vertex_index_map_generator.get()));
+	    boost::topological_sort(graph, front_inserter(order));
 	}
 	catch (const boost::not_a_dag&)
 	{
@@ -525,21 +535,49 @@ namespace storage
     void
     Actiongraph::Impl::commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks) const
     {
+	if (commit_options.num_threads > 1)
+	{
+	    commit_parallel(commit_options, commit_callbacks);
+	    return;
+	}
+
 	y2mil("commit begin");
 
 	CommitData commit_data(*this, Tense::PRESENT_CONTINUOUS);
 
-	for (const vertex_descriptor& vertex : order)
+	const map<vertex_descriptor, size_t> positions = get_positions();
+
+	vector<bool> done(order.size(), false);
+
+	for (size_t i = 0; i < order.size(); ++i)
 	{
-	    const Action::Base* action = graph[vertex].get();
+	    if (done[i])
+		continue;
 
-	    Text text = action->text(commit_data);
+	    // Actions are committed one after another so all actions marked
+	    // as done, except those of the new batch, are committed.
 
-	    y2mil("Commit Action \"" << text.native << "\" [" << action->details() << "]");
+	    vector<vertex_descriptor> vertices = get_batch(i, done, [&positions, &done](vertex_descriptor vertex) {
+		return done[positions.at(vertex)];
+	    });
+
+	    const Action::Base* action = graph[vertices.front()].get();
+
+	    Text text;
 
-	    if (commit_callbacks)
+	    for (vertex_descriptor vertex : vertices)
 	    {
-		commit_callbacks->message(text.translated);
+		Text tmp = graph[vertex]->text(commit_data);
+
+		y2mil("Commit Action \"" << tmp.native << "\" [" << graph[vertex]->details() << "]");
+
+		if (commit_callbacks)
+		{
+		    commit_callbacks->message(tmp.translated);
+		}
+
+		if (vertex == vertices.front())
+		    text = tmp;
 	    }
 
 	    if (action->nop)
@@ -547,7 +585,9 @@ namespace storage
 
 	    try
 	    {
-		action->commit(commit_data, commit_options);
+		release_tmp_mounts(action);
+
+		commit_batch(vertices, commit_data, commit_options);
 	    }
 	    catch (const Exception& e)
 	    {
@@ -564,10 +604,374 @@ namespace storage
     }
 
 
+    set<string>
+    Actiongraph::Impl::get_touched_names() const
+    {
+	set<string> ret;
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    const sid_t sid = graph[vertex]->sid;
+
+	    for (const Devicegraph* devicegraph : { lhs, static_cast<const Devicegraph*>(rhs) })
+	    {
+		if (!devicegraph->device_exists(sid))
+		    continue;
+
+		for (const Device* device : devicegraph->find_device(sid)->get_ancestors(true))
+		{
+		    if (is_blk_device(device))
+			ret.insert(to_blk_device(device)->get_name());
+		}
+	    }
+	}
+
+	return ret;
+    }
+
+
+    void
+    Actiongraph::Impl::release_tmp_mounts(const Action::Base* action) const
+    {
+	TmpMountCache& tmp_mount_cache = storage.get_impl().get_tmp_mount_cache();
+
+	const Devicegraph* devicegraph = rhs->device_exists(action->sid) ? rhs : lhs;
+
+	const Device* device = devicegraph->find_device(action->sid);
+
+	if (is_btrfs_subvolume(device))
+	    tmp_mount_cache.release_all_except(to_btrfs_subvolume(device)->get_btrfs()->get_sid());
+	else
+	    tmp_mount_cache.clear();
+    }
+
+
+    namespace
+    {
+
+	enum class BatchType { NONE, PARTED, BTRFS_SUBVOLUME };
+
+
+	/**
+	 * Returns the type of batch the action can be part of and the sid
+	 * of the device all actions of the batch must work on.
+	 */
+	pair<BatchType, sid_t>
+	get_batch_key(const Action::Base* action, const Actiongraph::Impl& actiongraph)
+	{
+	    const Partition* partition = get_parted_batch_partition(action, actiongraph);
+	    if (partition)
+		return make_pair(BatchType::PARTED, partition->get_partitionable()->get_sid());
+
+	    const BtrfsSubvolume* btrfs_subvolume = get_btrfs_subvolume_batch_subvolume(action, actiongraph);
+	    if (btrfs_subvolume)
+		return make_pair(BatchType::BTRFS_SUBVOLUME, btrfs_subvolume->get_btrfs()->get_sid());
+
+	    return make_pair(BatchType::NONE, 0);
+	}
+
+    }
+
+
+    map<Actiongraph::Impl::vertex_descriptor, size_t>
+    Actiongraph::Impl::get_positions() const
+    {
+	map<vertex_descriptor, size_t> positions;
+
+	for (size_t i = 0; i < order.size(); ++i)
+	    positions[order[i]] = i;
+
+	return positions;
+    }
+
+
+    vector<Actiongraph::Impl::vertex_descriptor>
+    Actiongraph::Impl::get_batch(size_t i, vector<bool>& done,
+				 const std::function<bool(vertex_descriptor)>& is_committed) const
+    {
+	vector<vertex_descriptor> ret = { order[i] };
+	done[i] = true;
+
+	const pair<BatchType, sid_t> key = get_batch_key(graph[order[i]].get(), *this);
+	if (key.first == BatchType::NONE)
+	    return ret;
+
+	// Later actions with the same key are added if all their parents
+	// are committed or in the batch. Since the order is a topological
+	// sort it is enough to check the parents.
+
+	set<vertex_descriptor> batch = { order[i] };
+
+	for (size_t j = i + 1; j < order.size(); ++j)
+	{
+	    if (done[j])
+		continue;
+
+	    const vertex_descriptor vertex = order[j];
+
+	    bool add = get_batch_key(graph[vertex].get(), *this) == key;
+
+	    if (add)
+	    {
+		for (vertex_descriptor parent : parents(vertex))
+		{
+		    if (batch.find(parent) == batch.end() && !is_committed(parent))
+		    {
+			add = false;
+			break;
+		    }
+		}
+	    }
+
+	    if (add)
+	    {
+		ret.push_back(vertex);
+		batch.insert(vertex);
+		done[j] = true;
+	    }
+	}
+
+	if (ret.size() > 1)
+	    y2mil("committing " << ret.size() << " actions in one batch");
+
+	return ret;
+    }
+
+
+    void
+    Actiongraph::Impl::commit_batch(const vector<vertex_descriptor>& vertices, CommitData& commit_data,
+				    const CommitOptions& commit_options) const
+    {
+	vector<const Action::Base*> actions;
+	for (vertex_descriptor vertex : vertices)
+	    actions.push_back(graph[vertex].get());
+
+	if (actions.size() == 1)
+	{
+	    actions.front()->commit(commit_data, commit_options);
+	    return;
+	}
+
+	switch (get_batch_key(actions.front(), *this).first)
+	{
+	    case BatchType::PARTED:
+		commit_parted_batch(actions, *this);
+		break;
+
+	    case BatchType::BTRFS_SUBVOLUME:
+		commit_btrfs_subvolume_batch(actions, *this);
+		break;
+
+	    case BatchType::NONE:
+		ST_THROW(LogicException("invalid batch"));
+	}
+    }
+
+
+    void
+    Actiongraph::Impl::commit_parallel(const CommitOptions& commit_options,
+				       const CommitCallbacks* commit_callbacks) const
+    {
+	y2mil("commit begin with " << commit_options.num_threads << " threads");
+
+	CommitData commit_data(*this, Tense::PRESENT_CONTINUOUS);
+
+	// Ready actions are started in the order of the serial commit.
+	// Thus with one thread the result is identical.
+
+	const map<vertex_descriptor, size_t> positions = get_positions();
+
+	map<vertex_descriptor, size_t> num_pending_parents;
+	set<size_t> ready;
+
+	for (const vertex_descriptor& vertex : order)
+	{
+	    size_t num_parents = boost::in_degree(vertex, graph);
+	    num_pending_parents[vertex] = num_parents;
+	    if (num_parents == 0)
+		ready.insert(positions.at(vertex));
+	}
+
+	// Actions marked as scheduled are committed, running or part of a
+	// batch. Batches are built like in the serial commit, but only
+	// committed actions can be parents of later actions of the batch.
+
+	vector<bool> scheduled(order.size(), false);
+	vector<bool> committed(order.size(), false);
+
+	std::mutex serial_mutex;
+
+	std::mutex finished_mutex;
+	std::condition_variable finished_condition;
+	deque<pair<vector<vertex_descriptor>, exception_ptr>> finished;
+
+	map<vertex_descriptor, Text> texts;
+
+	unsigned int num_running = 0;
+	exception_ptr first_error;
+
+	auto done = [this, &num_pending_parents, &positions, &ready, &committed](vertex_descriptor vertex) {
+	    committed[positions.at(vertex)] = true;
+
+	    for (vertex_descriptor child : children(vertex))
+	    {
+		if (--num_pending_parents[child] == 0)
+		    ready.insert(positions.at(child));
+	    }
+	};
+
+	ThreadPool thread_pool(commit_options.num_threads);
+
+	// Actions are not thread-safe. So they are serialised by a lock that
+	// is only released while waiting for external programs. The calling
+	// thread also holds the lock except while waiting for finished
+	// actions. The lock must be destroyed before the thread pool.
+
+	std::unique_lock<std::mutex> serial_lock(serial_mutex);
+
+	while (true)
+	{
+	    while (!first_error && !ready.empty() && num_running < commit_options.num_threads)
+	    {
+		const size_t i = *ready.begin();
+		ready.erase(ready.begin());
+
+		// Already committed as part of a batch.
+		if (scheduled[i])
+		    continue;
+
+		vector<vertex_descriptor> vertices = get_batch(i, scheduled, [&positions, &committed](vertex_descriptor vertex) {
+		    return committed[positions.at(vertex)];
+		});
+
+		for (vertex_descriptor vertex : vertices)
+		{
+		    const Text& text = texts[vertex] = graph[vertex]->text(commit_data);
+
+		    y2mil("Commit Action \"" << text.native << "\" [" << graph[vertex]->details() << "]");
+
+		    if (commit_callbacks)
+		    {
+			commit_callbacks->message(text.translated);
+		    }
+		}
+
+		if (graph[vertices.front()]->nop)
+		{
+		    for (vertex_descriptor vertex : vertices)
+			done(vertex);
+		    continue;
+		}
+
+		++num_running;
+
+		// The TmpMountCache is not enabled with several threads, see
+		// Storage::Impl::commit(), so no tmp mounts must be released.
+
+		thread_pool.add_task([this, vertices, &commit_data, &commit_options, &serial_mutex,
+				      &finished_mutex, &finished_condition, &finished]() {
+		    exception_ptr error;
+
+		    {
+			SerialLock lock(serial_mutex);
+
+			try
+			{
+			    commit_batch(vertices, commit_data, commit_options);
+			}
+			catch (...)
+			{
+			    error = current_exception();
+			}
+		    }
+
+		    {
+			std::lock_guard<std::mutex> lock(finished_mutex);
+			finished.emplace_back(vertices, error);
+		    }
+
+		    finished_condition.notify_one();
+		});
+	    }
+
+	    if (num_running == 0)
+		break;
+
+	    deque<pair<vector<vertex_descriptor>, exception_ptr>> tmp;
+
+	    serial_lock.unlock();
+
+	    {
+		std::unique_lock<std::mutex> lock(finished_mutex);
+		finished_condition.wait(lock, [&finished] { return !finished.empty(); });
+		tmp.swap(finished);
+	    }
+
+	    serial_lock.lock();
+
+	    for (const pair<vector<vertex_descriptor>, exception_ptr>& tmp2 : tmp)
+	    {
+		--num_running;
+
+		if (!tmp2.second)
+		{
+		    for (vertex_descriptor vertex : tmp2.first)
+			done(vertex);
+		    continue;
+		}
+
+		try
+		{
+		    rethrow_exception(tmp2.second);
+		}
+		catch (const Exception& e)
+		{
+		    ST_CAUGHT(e);
+
+		    if (first_error || !commit_callbacks ||
+			!commit_callbacks->error(texts[tmp2.first.front()].translated, e.what()))
+		    {
+			if (!first_error)
+			    first_error = tmp2.second;
+			continue;
+		    }
+
+		    y2mil("user decides to continue after error");
+
+		    for (vertex_descriptor vertex : tmp2.first)
+			done(vertex);
+		}
+		catch (...)
+		{
+		    if (!first_error)
+			first_error = tmp2.second;
+		}
+	    }
+	}
+
+	if (first_error)
+	{
+	    y2mil("commit stopped after error");
+
+	    try
+	    {
+		rethrow_exception(first_error);
+	    }
+	    catch (const Exception& e)
+	    {
+		ST_RETHROW(e);
+	    }
+	}
+
+	y2mil("commit end");
+    }
+
+
     void
     Actiongraph::Impl::generate_compound_actions(const Actiongraph* actiongraph)
     {
 	compound_actions.clear();
+	compound_action_target_devices.clear();
 
 	auto compound_actions = CompoundAction::Generator(actiongraph).generate();
 	for (auto action : compound_actions)
@@ -682,13 +1086,10 @@ namespace storage
 
 	fout << "// " << generated_string() << "\n\n";
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	const CommitData commit_data(*this, Tense:: SIMPLE_PRESENT);
 
 	boost::write_graphviz(fout, graph, write_vertex(commit_data, graphviz_flags),
-			      boost::default_writer(), write_graph(commit_data),
-			      vertex_index_map_generator.get());
+			      boost::default_writer(), write_graph(commit_data));
 
 	fout.close();
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -27,7 +27,9 @@
 
 #include <deque>
 #include <map>
+#include <set>
 #include <memory>
+#include <functional>
 #include <boost/noncopyable.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
@@ -43,6 +45,7 @@ namespace storage
     using std::vector;
     using std::deque;
     using std::map;
+    using std::set;
 
 
     class Devicegraph;
@@ -96,8 +99,15 @@ namespace storage
 
     private:
 
+	// The internal vertex_index property is required by the algorithms
+	// since VertexList=boost::listS provides no vertex index. It is
+	// assigned by add_vertex and made dense again after removing
+	// vertices.
+
+	typedef boost::property<boost::vertex_index_t, size_t, std::shared_ptr<Action::Base>> vertex_property_t;
+
 	typedef boost::adjacency_list<boost::vecS, boost::listS, boost::bidirectionalS,
-				      std::shared_ptr<Action::Base>> graph_t;
+				      vertex_property_t> graph_t;
 
     public:
 
@@ -174,9 +184,21 @@ namespace storage
 	vector<const Action::Base*> get_commit_actions() const;
 	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks) const;
 
+	/**
+	 * Returns the names of the blk devices possibly modified by the
+	 * actions, including the blk devices the modified devices are
+	 * based on, e.g. the disk of a partition. Used to invalidate the
+	 * information about these devices, see Storage::reprobe().
+	 */
+	set<string> get_touched_names() const;
+
 	void generate_compound_actions(const Actiongraph* actiongraph);
 	vector<const CompoundAction*> get_compound_actions() const;
 
+	// cache for CompoundAction::Impl::get_target_device(), cleared by
+	// generate_compound_actions()
+	mutable map<const Action::Base*, const Device*> compound_action_target_devices;
+
 	// special actions, TODO make private and provide interface
 	vertex_iterator mount_root_filesystem;
 	map<sid_t, vertex_descriptor> last_action_on_partition_table;
@@ -190,6 +212,38 @@ namespace storage
 	void remove_only_syncs();
 	void calculate_order();
 
+	void commit_parallel(const CommitOptions& commit_options,
+			     const CommitCallbacks* commit_callbacks) const;
+
+	/**
+	 * Returns the positions of the actions in the order.
+	 */
+	map<vertex_descriptor, size_t> get_positions() const;
+
+	/**
+	 * Returns the action at position i of the order together with the
+	 * following actions that can be committed with it in one batch,
+	 * see commit_parted_batch() and commit_btrfs_subvolume_batch().
+	 * An action is only added if all its parents are either committed,
+	 * according to is_committed, or part of the batch. The returned
+	 * actions are marked as done.
+	 */
+	vector<vertex_descriptor> get_batch(size_t i, vector<bool>& done,
+					    const std::function<bool(vertex_descriptor)>& is_committed) const;
+
+	/**
+	 * Commits the actions returned by get_batch().
+	 */
+	void commit_batch(const vector<vertex_descriptor>& vertices, CommitData& commit_data,
+			  const CommitOptions& commit_options) const;
+
+	/**
+	 * Unmounts the cached temporary mounts that must not be mounted
+	 * during the action. Only the temporary mounts of the btrfs are
+	 * kept for actions on btrfs subvolumes.
+	 */
+	void release_tmp_mounts(const Action::Base* action) const;
+
 	const Storage& storage;
 
 	const Devicegraph* lhs;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -31,11 +31,26 @@ namespace storage
     {
     public:
 
-	CommitOptions(bool force_rw)
-	    : force_rw(force_rw) {}
+	CommitOptions(bool force_rw, unsigned int num_threads = 1)
+	    : force_rw(force_rw), num_threads(num_threads) {}
 
 	const bool force_rw;
 
+	/**
+	 * Maximal number of actions committed in parallel. Actions not
+	 * depending on each other, e.g. creating filesystems on different
+	 * disks, are then committed in parallel. Only the external programs
+	 * run in parallel, the callbacks are still called one after another
+	 * from the calling thread. With 1 all actions are committed one
+	 * after another.
+	 *
+	 * With more than 1 the logger, see set_logger(), is also called
+	 * from the worker threads. So the logger must be thread-safe,
+	 * e.g. a logger implemented in the bindings must acquire the
+	 * interpreter lock.
+	 */
+	const unsigned int num_threads;
+
     };
 
 }
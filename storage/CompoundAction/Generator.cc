@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -20,7 +20,7 @@
  */
 
 
-#include <algorithm>
+#include <unordered_map>
 
 #include "storage/CompoundAction/Generator.h"
 #include "storage/CompoundActionImpl.h"
@@ -38,44 +38,32 @@ namespace storage
     {
 	vector<CompoundAction*> compound_actions;
 
+	// The compound actions by their target device. The device objects
+	// and not the sids are used as key since the target device of
+	// delete actions is in the LHS devicegraph.
+
+	std::unordered_map<const Device*, CompoundAction*> compound_actions_by_target;
+
 	for(auto& commit_action : actiongraph->get_commit_actions())
 	{
 	    auto target = CompoundAction::Impl::get_target_device(actiongraph, commit_action);
-	    
-	    auto compound_action = find_by_target_device(compound_actions, target);
 
-	    if (compound_action)
-		compound_action->get_impl().add_commit_action(commit_action);
+	    auto it = compound_actions_by_target.find(target);
+
+	    if (it != compound_actions_by_target.end())
+		it->second->get_impl().add_commit_action(commit_action);
 	    else
 	    {
-		compound_action = new CompoundAction(actiongraph);
+		auto compound_action = new CompoundAction(actiongraph);
 		compound_action->get_impl().set_target_device(target);
 		compound_action->get_impl().add_commit_action(commit_action);
 		compound_actions.push_back(compound_action);
+		compound_actions_by_target[target] = compound_action;
 	    }
 	}
 	
 	return compound_actions;
     }
 
-    
-    CompoundAction*
-    CompoundAction::Generator::find_by_target_device(const vector<CompoundAction*>& compound_actions, const Device* device)
-    {
-	auto begin = compound_actions.begin();
-	auto end = compound_actions.end();
-
-	auto it = find_if(begin, end, 
-		[device](CompoundAction* a) -> bool 
-		{
-		    return a->get_target_device() == device;
-		});
-
-	if (it != end)
-	    return *it;
-	else
-	    return nullptr;
-    }
-
 }
 
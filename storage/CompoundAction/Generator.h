@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -45,10 +45,6 @@ namespace storage
 
 	vector<CompoundAction*> generate() const;
 
-    private:
-
-	static CompoundAction* find_by_target_device(const vector<CompoundAction*>& compound_actions, const Device* device);
-
     private:
 
 	const Actiongraph* actiongraph;
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -145,7 +145,20 @@ namespace storage
     const Device*
     CompoundAction::Impl::get_target_device(const Actiongraph* actiongraph, const Action::Base* action)
     {
-	return get_target_device(device(actiongraph, action));
+	// Finding the target device walks the devicegraph so the result is
+	// cached per action.
+
+	map<const Action::Base*, const Device*>& cache = actiongraph->get_impl().compound_action_target_devices;
+
+	map<const Action::Base*, const Device*>::const_iterator it = cache.find(action);
+	if (it != cache.end())
+	    return it->second;
+
+	const Device* target_device = get_target_device(device(actiongraph, action));
+
+	cache[action] = target_device;
+
+	return target_device;
     }
 
 
@@ -46,13 +46,13 @@
 #include "storage/Devices/ImplicitPt.h"
 #include "storage/Devices/Partition.h"
 #include "storage/Devices/PartitionTable.h"
-#include "storage/Devices/LvmPv.h"
-#include "storage/Devices/LvmVg.h"
-#include "storage/Devices/LvmLv.h"
+#include "storage/Devices/LvmPvImpl.h"
+#include "storage/Devices/LvmVgImpl.h"
+#include "storage/Devices/LvmLvImpl.h"
 #include "storage/Devices/Encryption.h"
 #include "storage/Devices/Luks.h"
 #include "storage/Devices/Bcache.h"
-#include "storage/Devices/BcacheCset.h"
+#include "storage/Devices/BcacheCsetImpl.h"
 #include "storage/Filesystems/Ext2.h"
 #include "storage/Filesystems/Ext3.h"
 #include "storage/Filesystems/Ext4.h"
@@ -80,6 +80,72 @@
 namespace storage
 {
 
+    namespace
+    {
+
+	const string*
+	name_of(const Device* device)
+	{
+	    if (is_blk_device(device))
+		return &to_blk_device(device)->get_impl().get_name();
+
+	    return nullptr;
+	}
+
+
+	const string*
+	uuid_of(const Device* device)
+	{
+	    if (is_lvm_vg(device))
+		return &to_lvm_vg(device)->get_impl().get_uuid();
+
+	    if (is_lvm_pv(device))
+		return &to_lvm_pv(device)->get_impl().get_uuid();
+
+	    if (is_lvm_lv(device))
+		return &to_lvm_lv(device)->get_impl().get_uuid();
+
+	    if (is_bcache_cset(device))
+		return &to_bcache_cset(device)->get_impl().get_uuid();
+
+	    return nullptr;
+	}
+
+
+	void
+	erase_from_index(std::unordered_multimap<string, Devicegraph::Impl::vertex_descriptor>& index,
+			 const string& key, Devicegraph::Impl::vertex_descriptor vertex)
+	{
+	    auto range = index.equal_range(key);
+
+	    for (auto it = range.first; it != range.second; ++it)
+	    {
+		if (it->second == vertex)
+		{
+		    index.erase(it);
+		    return;
+		}
+	    }
+	}
+
+
+	vector<Devicegraph::Impl::vertex_descriptor>
+	find_in_index(const std::unordered_multimap<string, Devicegraph::Impl::vertex_descriptor>& index,
+		      const string& key)
+	{
+	    vector<Devicegraph::Impl::vertex_descriptor> ret;
+
+	    auto range = index.equal_range(key);
+
+	    for (auto it = range.first; it != range.second; ++it)
+		ret.push_back(it->second);
+
+	    return ret;
+	}
+
+    }
+
+
     bool
     Devicegraph::Impl::operator==(const Impl& rhs) const
     {
@@ -218,15 +284,87 @@ namespace storage
 	}
 
 	{
-	    // look for cycles
+	    // check vertex index
+
+	    if (vertex_by_index.size() != num_devices())
+		ST_THROW(LogicException("vertex index has wrong size"));
+
+	    for (vertex_descriptor vertex : vertices())
+	    {
+		size_t index = boost::get(boost::vertex_index, graph, vertex);
+		if (index >= vertex_by_index.size() || vertex_by_index[index] != vertex)
+		    ST_THROW(LogicException("wrong vertex in vertex index"));
+	    }
+	}
+
+	{
+	    // check sid indexes
+
+	    if (vertex_by_sid.size() != num_devices() || edge_by_sids.size() != num_holders())
+		ST_THROW(LogicException("sid indexes have wrong size"));
+
+	    for (vertex_descriptor vertex : vertices())
+	    {
+		if (find_vertex(graph[vertex]->get_sid()) != vertex)
+		    ST_THROW(LogicException("wrong vertex in sid index"));
+	    }
+
+	    for (edge_descriptor edge : edges())
+	    {
+		sid_pair_t sids = edge_sids(edge);
+		if (find_edge(sids.first, sids.second) != edge)
+		    ST_THROW(LogicException("wrong edge in sid index"));
+	    }
+	}
 
-	    VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
+	{
+	    // check name and uuid indexes
+
+	    size_t num_names = 0;
+	    size_t num_uuids = 0;
+
+	    for (vertex_descriptor vertex : vertices())
+	    {
+		const Device* device = graph[vertex].get();
+
+		if (const string* name = name_of(device))
+		{
+		    ++num_names;
+
+		    vector<vertex_descriptor> tmp = find_vertices_by_name(*name);
+		    if (find(tmp.begin(), tmp.end(), vertex) == tmp.end())
+			ST_THROW(LogicException("vertex missing in name index"));
+		}
+
+		if (const string* uuid = uuid_of(device))
+		{
+		    ++num_uuids;
+
+		    vector<vertex_descriptor> tmp = find_vertices_by_uuid(*uuid);
+		    if (find(tmp.begin(), tmp.end(), vertex) == tmp.end())
+			ST_THROW(LogicException("vertex missing in uuid index"));
+		}
+	    }
+
+	    if (vertex_by_name.size() != num_names || vertex_by_uuid.size() != num_uuids)
+		ST_THROW(LogicException("name or uuid index has wrong size"));
+	}
+
+	{
+	    // check type buckets
+
+	    vector<vertex_descriptor> tmp = get_vertices_of_type<const Device>();
+	    if (!std::equal(tmp.begin(), tmp.end(), vertices().begin(), vertices().end()))
+		ST_THROW(LogicException("type buckets inconsistent"));
+	}
+
+	{
+	    // look for cycles
 
 	    bool has_cycle = false;
 
 	    CycleDetector cycle_detector(has_cycle);
-	    boost::depth_first_search(graph, visitor(cycle_detector).
-				      vertex_index_map(vertex_index_map_generator.get()));
+	    boost::depth_first_search(graph, visitor(cycle_detector));
 
 	    if (has_cycle)
 		ST_THROW(Exception("devicegraph has a cycle"));
@@ -313,7 +451,98 @@ namespace storage
     Devicegraph::Impl::vertex_descriptor
     Devicegraph::Impl::add_vertex(Device* device)
     {
-	return boost::add_vertex(shared_ptr<Device>(device), graph);
+	sid_t sid = device->get_sid();
+
+	if (vertex_by_sid.find(sid) != vertex_by_sid.end())
+	    ST_THROW(LogicException(sformat("sid %d not unique within graph", sid)));
+
+	vertex_descriptor vertex = boost::add_vertex(vertex_property_t(vertex_by_index.size(),
+								     shared_ptr<Device>(device)), graph);
+
+	vertex_by_index.push_back(vertex);
+
+	vertex_by_sid[sid] = vertex;
+
+	add_to_indexes(vertex);
+
+	return vertex;
+    }
+
+
+    void
+    Devicegraph::Impl::add_to_indexes(vertex_descriptor vertex)
+    {
+	const Device* device = graph[vertex].get();
+
+	size_t sequence = next_sequence++;
+	sequence_by_sid[device->get_sid()] = sequence;
+	type_buckets[device->get_impl().get_classname()][sequence] = vertex;
+
+	if (const string* name = name_of(device))
+	    vertex_by_name.emplace(*name, vertex);
+
+	if (const string* uuid = uuid_of(device))
+	    vertex_by_uuid.emplace(*uuid, vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::remove_from_indexes(vertex_descriptor vertex)
+    {
+	const Device* device = graph[vertex].get();
+
+	std::unordered_map<sid_t, size_t>::iterator it = sequence_by_sid.find(device->get_sid());
+	if (it != sequence_by_sid.end())
+	{
+	    std::map<string, type_bucket_t>::iterator type_bucket =
+		type_buckets.find(device->get_impl().get_classname());
+	    if (type_bucket != type_buckets.end())
+	    {
+		type_bucket->second.erase(it->second);
+		if (type_bucket->second.empty())
+		    type_buckets.erase(type_bucket);
+	    }
+
+	    sequence_by_sid.erase(it);
+	}
+
+	if (const string* name = name_of(device))
+	    erase_from_index(vertex_by_name, *name, vertex);
+
+	if (const string* uuid = uuid_of(device))
+	    erase_from_index(vertex_by_uuid, *uuid, vertex);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_name(const string& name) const
+    {
+	return find_in_index(vertex_by_name, name);
+    }
+
+
+    vector<Devicegraph::Impl::vertex_descriptor>
+    Devicegraph::Impl::find_vertices_by_uuid(const string& uuid) const
+    {
+	return find_in_index(vertex_by_uuid, uuid);
+    }
+
+
+    void
+    Devicegraph::Impl::update_name_index(vertex_descriptor vertex, const string& old_name,
+					 const string& new_name)
+    {
+	erase_from_index(vertex_by_name, old_name, vertex);
+	vertex_by_name.emplace(new_name, vertex);
+    }
+
+
+    void
+    Devicegraph::Impl::update_uuid_index(vertex_descriptor vertex, const string& old_uuid,
+					 const string& new_uuid)
+    {
+	erase_from_index(vertex_by_uuid, old_uuid, vertex);
+	vertex_by_uuid.emplace(new_uuid, vertex);
     }
 
 
@@ -328,6 +557,8 @@ namespace storage
 	    ST_THROW(HolderAlreadyExists(graph[source_vertex]->get_sid(),
 					 graph[target_vertex]->get_sid()));
 
+	edge_by_sids[edge_sids(tmp.first)] = tmp.first;
+
 	// TODO should also set devicegraph and edge in holder but the
 	// devicegraph is not available here
 
@@ -335,6 +566,13 @@ namespace storage
     }
 
 
+    Devicegraph::Impl::sid_pair_t
+    Devicegraph::Impl::edge_sids(edge_descriptor edge) const
+    {
+	return make_pair(graph[source(edge)]->get_sid(), graph[target(edge)]->get_sid());
+    }
+
+
     set<sid_t>
     Devicegraph::Impl::get_device_sids() const
     {
@@ -358,54 +596,36 @@ namespace storage
     bool
     Devicegraph::Impl::device_exists(sid_t sid) const
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return true;
-	}
-
-	return false;
+	return vertex_by_sid.find(sid) != vertex_by_sid.end();
     }
 
 
     bool
     Devicegraph::Impl::holder_exists(sid_t source_sid, sid_t target_sid) const
     {
-	for (edge_descriptor edge : edges())
-	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return true;
-	}
-
-	return false;
+	return edge_by_sids.find(make_pair(source_sid, target_sid)) != edge_by_sids.end();
     }
 
 
     Devicegraph::Impl::vertex_descriptor
     Devicegraph::Impl::find_vertex(sid_t sid) const
     {
-	for (vertex_descriptor vertex : vertices())
-	{
-	    if (graph[vertex]->get_sid() == sid)
-		return vertex;
-	}
+	vertex_by_sid_t::const_iterator it = vertex_by_sid.find(sid);
+	if (it == vertex_by_sid.end())
+	    ST_THROW(DeviceNotFoundBySid(sid));
 
-	ST_THROW(DeviceNotFoundBySid(sid));
-     }
+	return it->second;
+    }
 
 
     Devicegraph::Impl::edge_descriptor
     Devicegraph::Impl::find_edge(sid_t source_sid, sid_t target_sid) const
     {
-	for (edge_descriptor edge : edges())
-	{
-	    if (graph[source(edge)]->get_sid() == source_sid &&
-		graph[target(edge)]->get_sid() == target_sid)
-		return edge;
-	}
+	edge_by_sids_t::const_iterator it = edge_by_sids.find(make_pair(source_sid, target_sid));
+	if (it == edge_by_sids.end())
+	    ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
 
-	ST_THROW(HolderNotFoundBySids(source_sid, target_sid));
+	return it->second;
     }
 
 
@@ -428,16 +648,51 @@ namespace storage
     }
 
 
+    void
+    Devicegraph::Impl::set_vertex_index(vertex_descriptor vertex, size_t index)
+    {
+	boost::put(boost::vertex_index, graph, vertex, index);
+    }
+
+
     void
     Devicegraph::Impl::clear()
     {
 	graph.clear();
+
+	vertex_by_index.clear();
+
+	vertex_by_sid.clear();
+	edge_by_sids.clear();
+
+	vertex_by_name.clear();
+	vertex_by_uuid.clear();
+
+	type_buckets.clear();
+	sequence_by_sid.clear();
+	next_sequence = 0;
     }
 
 
     void
     Devicegraph::Impl::remove_vertex(vertex_descriptor vertex)
     {
+	for (edge_descriptor edge : boost::make_iterator_range(boost::in_edges(vertex, graph)))
+	    edge_by_sids.erase(edge_sids(edge));
+
+	for (edge_descriptor edge : boost::make_iterator_range(boost::out_edges(vertex, graph)))
+	    edge_by_sids.erase(edge_sids(edge));
+
+	vertex_by_sid.erase(graph[vertex]->get_sid());
+
+	remove_from_indexes(vertex);
+
+	size_t index = boost::get(boost::vertex_index, graph, vertex);
+	vertex_descriptor last_vertex = vertex_by_index.back();
+	set_vertex_index(last_vertex, index);
+	vertex_by_index[index] = last_vertex;
+	vertex_by_index.pop_back();
+
 	boost::clear_vertex(vertex, graph);
 	boost::remove_vertex(vertex, graph);
     }
@@ -446,6 +701,8 @@ namespace storage
     void
     Devicegraph::Impl::remove_edge(edge_descriptor edge)
     {
+	edge_by_sids.erase(edge_sids(edge));
+
 	boost::remove_edge(edge, graph);
     }
 
@@ -454,6 +711,106 @@ namespace storage
     Devicegraph::Impl::swap(Devicegraph::Impl& x)
     {
 	graph.swap(x.graph);
+
+	vertex_by_index.swap(x.vertex_by_index);
+
+	vertex_by_sid.swap(x.vertex_by_sid);
+	edge_by_sids.swap(x.edge_by_sids);
+
+	vertex_by_name.swap(x.vertex_by_name);
+	vertex_by_uuid.swap(x.vertex_by_uuid);
+
+	type_buckets.swap(x.type_buckets);
+	sequence_by_sid.swap(x.sequence_by_sid);
+	std::swap(next_sequence, x.next_sequence);
+    }
+
+
+    void
+    Devicegraph::Impl::copy(Devicegraph& dest) const
+    {
+	Impl& dest_impl = dest.get_impl();
+
+	dest_impl.clear();
+
+	// The graph is copied directly instead of with boost::copy_graph
+	// to build the indexes while copying. The vertices of dest get the
+	// same vertex indexes as the vertices of this devicegraph, so
+	// vertex_by_index of dest also maps the vertices.
+
+	dest_impl.vertex_by_index.resize(num_devices());
+
+	dest_impl.vertex_by_sid.reserve(num_devices());
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    Device* device = graph[vertex]->clone();
+
+	    size_t index = boost::get(boost::vertex_index, graph, vertex);
+
+	    vertex_descriptor dest_vertex = boost::add_vertex(vertex_property_t(index, shared_ptr<Device>(device)),
+							      dest_impl.graph);
+	    device->get_impl().set_devicegraph_and_vertex(&dest, dest_vertex);
+
+	    dest_impl.vertex_by_index[index] = dest_vertex;
+
+	    dest_impl.vertex_by_sid[device->get_sid()] = dest_vertex;
+	    dest_impl.add_to_indexes(dest_vertex);
+	}
+
+	dest_impl.edge_by_sids.reserve(num_holders());
+
+	for (edge_descriptor edge : edges())
+	{
+	    Holder* holder = graph[edge]->clone();
+
+	    vertex_descriptor source = dest_impl.vertex_by_index[boost::get(boost::vertex_index, graph,
+									    boost::source(edge, graph))];
+	    vertex_descriptor target = dest_impl.vertex_by_index[boost::get(boost::vertex_index, graph,
+									    boost::target(edge, graph))];
+
+	    edge_descriptor dest_edge = boost::add_edge(source, target, shared_ptr<Holder>(holder),
+							dest_impl.graph).first;
+	    holder->get_impl().set_devicegraph_and_edge(&dest, dest_edge);
+
+	    dest_impl.edge_by_sids[edge_sids(edge)] = dest_edge;
+	}
+    }
+
+
+    void
+    Devicegraph::Impl::rebuild_indexes()
+    {
+	vertex_by_index.clear();
+	vertex_by_index.reserve(num_devices());
+
+	for (vertex_descriptor vertex : vertices())
+	{
+	    set_vertex_index(vertex, vertex_by_index.size());
+	    vertex_by_index.push_back(vertex);
+	}
+
+	vertex_by_sid.clear();
+	vertex_by_sid.reserve(num_devices());
+
+	for (vertex_descriptor vertex : vertices())
+	    vertex_by_sid[graph[vertex]->get_sid()] = vertex;
+
+	edge_by_sids.clear();
+	edge_by_sids.reserve(num_holders());
+
+	for (edge_descriptor edge : edges())
+	    edge_by_sids[edge_sids(edge)] = edge;
+
+	vertex_by_name.clear();
+	vertex_by_uuid.clear();
+
+	type_buckets.clear();
+	sequence_by_sid.clear();
+	next_sequence = 0;
+
+	for (vertex_descriptor vertex : vertices())
+	    add_to_indexes(vertex);
     }
 
 
@@ -535,12 +892,9 @@ namespace storage
     {
 	vector<vertex_descriptor> ret;
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	VertexRecorder<vertex_descriptor> vertex_recorder(false, ret);
 
-	boost::breadth_first_search(graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	boost::breadth_first_search(graph, vertex, visitor(vertex_recorder));
 
 	if (!itself)
 	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
@@ -558,12 +912,9 @@ namespace storage
 
 	reverse_graph_t reverse_graph(graph);
 
-	VertexIndexMapGenerator<reverse_graph_t> vertex_index_map_generator(reverse_graph);
-
 	VertexRecorder<vertex_descriptor> vertex_recorder(false, ret);
 
-	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder));
 
 	if (!itself)
 	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
@@ -577,12 +928,9 @@ namespace storage
     {
 	vector<vertex_descriptor> ret;
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	VertexRecorder<vertex_descriptor> vertex_recorder(true, ret);
 
-	boost::breadth_first_search(graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	boost::breadth_first_search(graph, vertex, visitor(vertex_recorder));
 
 	if (!itself)
 	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
@@ -600,12 +948,9 @@ namespace storage
 
 	reverse_graph_t reverse_graph(graph);
 
-	VertexIndexMapGenerator<reverse_graph_t> vertex_index_map_generator(graph);
-
 	VertexRecorder<vertex_descriptor> vertex_recorder(true, ret);
 
-	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder).
-				    vertex_index_map(vertex_index_map_generator.get()));
+	boost::breadth_first_search(reverse_graph, vertex, visitor(vertex_recorder));
 
 	if (!itself)
 	    ret.erase(remove(ret.begin(), ret.end(), vertex), ret.end());
@@ -1006,10 +1351,8 @@ namespace storage
 	// needs of YaST).  Just keep a write_graphviz function here for debugging
 	// and move the thing YaST needs to yast2-storage.
 
-	VertexIndexMapGenerator<graph_t> vertex_index_map_generator(graph);
-
 	boost::write_graphviz(fout, graph, write_vertex(*this, graphviz_flags), write_edge(*this),
-			      write_graph(*this), vertex_index_map_generator.get());
+			      write_graph(*this));
 
 	fout.close();
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) 2016 SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -26,7 +26,11 @@
 
 
 #include <set>
+#include <map>
+#include <unordered_map>
+#include <algorithm>
 #include <boost/noncopyable.hpp>
+#include <boost/functional/hash.hpp>
 #include <boost/graph/adjacency_list.hpp>
 
 #include "storage/Devices/Device.h"
@@ -58,8 +62,14 @@ namespace storage
 	// properties, see:
 	// http://www.boost.org/doc/libs/1_56_0/libs/graph/doc/bundles.html
 
+	// With VertexList=boost::listS the graph has no vertex index which
+	// many algorithms need. So an internal vertex_index property is
+	// added and kept dense, see add_vertex and remove_vertex.
+
+	typedef boost::property<boost::vertex_index_t, size_t, std::shared_ptr<Device>> vertex_property_t;
+
 	typedef boost::adjacency_list<boost::setS, boost::listS, boost::bidirectionalS,
-				      std::shared_ptr<Device>, std::shared_ptr<Holder>> graph_t;
+				      vertex_property_t, std::shared_ptr<Holder>> graph_t;
 
 	typedef graph_t::vertex_descriptor vertex_descriptor;
 	typedef graph_t::edge_descriptor edge_descriptor;
@@ -114,6 +124,21 @@ namespace storage
 	vertex_descriptor find_vertex(sid_t sid) const;
 	edge_descriptor find_edge(sid_t source_sid, sid_t target_sid) const;
 
+	/**
+	 * Find vertices by block device name resp. by uuid of LVM VGs, PVs,
+	 * LVs and bcache csets. Used by find_by_name() and find_by_uuid() in
+	 * FindBy.h. The vertices still have to be checked for the wanted type.
+	 */
+	vector<vertex_descriptor> find_vertices_by_name(const string& name) const;
+	vector<vertex_descriptor> find_vertices_by_uuid(const string& uuid) const;
+
+	/**
+	 * Update the name resp. uuid index. Must be called by the setters of
+	 * devices already in the devicegraph.
+	 */
+	void update_name_index(vertex_descriptor vertex, const string& old_name, const string& new_name);
+	void update_uuid_index(vertex_descriptor vertex, const string& old_uuid, const string& new_uuid);
+
 	vertex_descriptor source(edge_descriptor edge) const { return boost::source(edge, graph); }
 	vertex_descriptor target(edge_descriptor edge) const { return boost::target(edge, graph); }
 
@@ -165,18 +190,19 @@ namespace storage
 	vector<edge_descriptor> out_edges(vertex_descriptor vertex) const;
 
 
+	/**
+	 * Get all devices of Type. Uses the per-type buckets so that only
+	 * devices of the matching types are visited. The devices are
+	 * returned in the same order as when iterating over all vertices.
+	 */
 	template<typename Type>
 	vector<Type*>
 	get_devices_of_type() const
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
-	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device)
-		    ret.push_back(device);
-	    }
+	    for (vertex_descriptor vertex : get_vertices_of_type<Type>())
+		ret.push_back(static_cast<Type*>(graph[vertex].get()));
 
 	    return ret;
 	}
@@ -189,10 +215,10 @@ namespace storage
 	{
 	    vector<Type*> ret;
 
-	    for (vertex_descriptor vertex : vertices())
+	    for (vertex_descriptor vertex : get_vertices_of_type<Type>())
 	    {
-		Type* device = dynamic_cast<Type*>(graph[vertex].get());
-		if (device && pred(device))
+		Type* device = static_cast<Type*>(graph[vertex].get());
+		if (pred(device))
 		    ret.push_back(device);
 	    }
 
@@ -271,6 +297,19 @@ namespace storage
 
 	void swap(Devicegraph::Impl& x);
 
+	/**
+	 * Replaces the content of dest with clones of all devices and
+	 * holders of this devicegraph.
+	 */
+	void copy(Devicegraph& dest) const;
+
+	/**
+	 * Rebuild the vertex index and the sid, name and uuid indexes from
+	 * scratch. Only required after the graph was modified without using
+	 * the functions of this class or after sids changed.
+	 */
+	void rebuild_indexes();
+
 	const Storage* get_storage() const { return storage; }
 
 	graph_t graph;		// TODO private?
@@ -279,6 +318,99 @@ namespace storage
 
 	const Storage* storage;
 
+	// Indexes to find vertices and edges by sids in constant time. Kept
+	// up to date by add_vertex, remove_vertex, add_edge, remove_edge,
+	// clear and swap. A vertex is only added after the device got its
+	// sid. Changing the sid afterwards, see Device::Impl::set_sid(),
+	// requires calling rebuild_indexes.
+
+	typedef pair<sid_t, sid_t> sid_pair_t;
+
+	typedef std::unordered_map<sid_t, vertex_descriptor> vertex_by_sid_t;
+	typedef std::unordered_map<sid_pair_t, edge_descriptor, boost::hash<sid_pair_t>> edge_by_sids_t;
+
+	vertex_by_sid_t vertex_by_sid;
+	edge_by_sids_t edge_by_sids;
+
+	sid_pair_t edge_sids(edge_descriptor edge) const;
+
+	// The vertices by their vertex index. Kept up to date by add_vertex,
+	// remove_vertex, clear and swap. When removing a vertex the vertex
+	// with the highest index takes over the index of the removed vertex
+	// so that the indexes stay in the range [0, num_devices()).
+
+	vector<vertex_descriptor> vertex_by_index;
+
+	void set_vertex_index(vertex_descriptor vertex, size_t index);
+
+	// Indexes to find vertices by name and uuid. Names and uuids are not
+	// unique, e.g. new LVM LVs all have an empty uuid. Kept up to date by
+	// add_vertex, remove_vertex, clear and swap and by the name and uuid
+	// setters of the devices.
+
+	typedef std::unordered_multimap<string, vertex_descriptor> vertex_by_string_t;
+
+	vertex_by_string_t vertex_by_name;
+	vertex_by_string_t vertex_by_uuid;
+
+	// Buckets of vertices per device type, keyed by the classname of
+	// the concrete type. Within a bucket the vertices are ordered by a
+	// sequence number assigned when adding the vertex. Since boost
+	// appends new vertices to the vertex list this is also the order of
+	// vertices(). Empty buckets are removed.
+
+	typedef std::map<size_t, vertex_descriptor> type_bucket_t;
+
+	std::map<string, type_bucket_t> type_buckets;
+
+	std::unordered_map<sid_t, size_t> sequence_by_sid;
+
+	size_t next_sequence = 0;
+
+	void add_to_indexes(vertex_descriptor vertex);
+	void remove_from_indexes(vertex_descriptor vertex);
+
+	/**
+	 * Get the vertices of all buckets whose devices are of Type. For
+	 * each bucket it is enough to check the first device since all
+	 * devices in a bucket have the same concrete type. Since the buckets
+	 * are already ordered the buckets only have to be merged.
+	 */
+	template<typename Type>
+	vector<vertex_descriptor>
+	get_vertices_of_type() const
+	{
+	    typedef pair<size_t, vertex_descriptor> value_t;
+
+	    vector<value_t> tmp;
+
+	    for (const std::map<string, type_bucket_t>::value_type& type_bucket : type_buckets)
+	    {
+		const type_bucket_t& bucket = type_bucket.second;
+
+		if (!dynamic_cast<const Type*>(graph[bucket.begin()->second].get()))
+		    continue;
+
+		size_t middle = tmp.size();
+
+		tmp.insert(tmp.end(), bucket.begin(), bucket.end());
+
+		if (middle > 0)
+		    std::inplace_merge(tmp.begin(), tmp.begin() + middle, tmp.end(),
+				       [](const value_t& lhs, const value_t& rhs) {
+					   return lhs.first < rhs.first;
+				       });
+	    }
+
+	    vector<vertex_descriptor> ret;
+	    ret.reserve(tmp.size());
+
+	    for (const value_t& value : tmp)
+		ret.push_back(value.second);
+
+	    return ret;
+	}
+
     };
 
 }
@@ -189,6 +189,16 @@ namespace storage
     }
 
 
+    void
+    BcacheCset::Impl::set_uuid(const string& uuid)
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().update_uuid_index(get_vertex(), Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
     BcacheCset*
     BcacheCset::Impl::find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
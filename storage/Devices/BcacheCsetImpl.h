@@ -73,7 +73,7 @@ namespace storage
 	virtual uint64_t used_features() const override;
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	virtual bool equal(const Device::Impl& rhs) const override;
 	virtual void log_diff(std::ostream& log, const Device::Impl& rhs_base) const override;
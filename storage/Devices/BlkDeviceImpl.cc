@@ -28,6 +28,7 @@
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/FileUtils.h"
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/Devices/LuksImpl.h"
 #include "storage/Devices/LvmPv.h"
@@ -158,6 +159,9 @@ namespace storage
     void
     BlkDevice::Impl::set_name(const string& name)
     {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().update_name_index(get_vertex(), Impl::name, name);
+
 	Impl::name = name;
     }
 
@@ -605,30 +609,26 @@ namespace storage
     void
     wait_for_devices(const vector<const BlkDevice*>& blk_devices)
     {
-	SystemCmd(UDEVADMBIN_SETTLE);
-
+	vector<string> names;
 	for (const BlkDevice* blk_device : blk_devices)
+	    names.push_back(blk_device->get_name());
+
+	// Only settle if some devices do not exist yet.
+
+	vector<string> missing = wait_for_files(names, std::chrono::milliseconds(0));
+	if (missing.empty())
 	{
-	    string name = blk_device->get_name();
+	    y2mil("names:" << names << " exist");
+	    return;
+	}
 
-	    bool exists = access(name.c_str(), R_OK) == 0;
-	    y2mil("name:" << name << " exists:" << exists);
+	SystemCmd(UDEVADMBIN_SETTLE);
 
-	    if (!exists)
-	    {
-		for (int count = 0; count < 500; ++count)
-		{
-		    usleep(10000);
-		    exists = access(name.c_str(), R_OK) == 0;
-		    if (exists)
-			break;
-		}
-		y2mil("name:" << name << " exists:" << exists);
-	    }
+	missing = wait_for_files(missing, std::chrono::seconds(5));
+	y2mil("names:" << names << " missing:" << missing);
 
-	    if (!exists)
-		ST_THROW(Exception("wait_for_devices failed " + name));
-	}
+	if (!missing.empty())
+	    ST_THROW(Exception("wait_for_devices failed " + missing.front()));
     }
 
 }
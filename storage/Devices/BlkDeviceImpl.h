@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -188,7 +188,8 @@ namespace storage
 
 
     /**
-     * Run "udevadm settle" and check existence of all blk devices.
+     * Wait until the device nodes of all blk devices exist. Runs "udevadm
+     * settle" only if some are missing.
      */
     void wait_for_devices(const vector<const BlkDevice*>& blk_devices);
 
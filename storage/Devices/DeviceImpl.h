@@ -107,11 +107,19 @@ namespace storage
 	const Storage* get_storage() const;
 
 	sid_t get_sid() const { return sid; }
+
+	/**
+	 * The indexes of the devicegraph use the sid. So after changing the
+	 * sid of a device already in a devicegraph
+	 * Devicegraph::Impl::rebuild_indexes() must be called.
+	 */
 	void set_sid(sid_t sid) { Impl::sid = sid; }
 
 	void set_devicegraph_and_vertex(Devicegraph* devicegraph,
 					Devicegraph::Impl::vertex_descriptor vertex);
 
+	bool has_devicegraph() const { return devicegraph; }
+
 	Devicegraph* get_devicegraph();
 	const Devicegraph* get_devicegraph() const;
 
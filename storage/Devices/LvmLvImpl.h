@@ -81,7 +81,7 @@ namespace storage
 	LvType get_lv_type() const { return lv_type; }
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	unsigned long long number_of_extents() const { return get_region().get_length(); }
 
@@ -192,6 +192,16 @@ namespace storage
     }
 
 
+    void
+    LvmPv::Impl::set_uuid(const string& uuid)
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().update_uuid_index(get_vertex(), Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
     LvmPv*
     LvmPv::Impl::find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
@@ -414,6 +414,16 @@ namespace storage
     }
 
 
+    void
+    LvmVg::Impl::set_uuid(const string& uuid)
+    {
+	if (has_devicegraph())
+	    get_devicegraph()->get_impl().update_uuid_index(get_vertex(), Impl::uuid, uuid);
+
+	Impl::uuid = uuid;
+    }
+
+
     LvmVg*
     LvmVg::Impl::find_by_uuid(Devicegraph* devicegraph, const std::string& uuid)
     {
@@ -95,7 +95,7 @@ namespace storage
 	void set_vg_name(const string& vg_name);
 
 	const string& get_uuid() const { return uuid; }
-	void set_uuid(const string& uuid) { Impl::uuid = uuid; }
+	void set_uuid(const string& uuid);
 
 	LvmPv* add_lvm_pv(BlkDevice* blk_device);
 	void remove_lvm_pv(BlkDevice* blk_device);
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -627,10 +627,24 @@ namespace storage
     Partition::Impl::do_create()
     {
 	const Partitionable* partitionable = get_partitionable();
-	const PartitionTable* partition_table = get_partition_table();
 
 	string cmd_line = PARTEDBIN " --script --wipesignatures " + quote(partitionable->get_name()) +
-	    " unit s mkpart ";
+	    " " + get_parted_create_commands();
+
+	SystemCmd(UDEVADMBIN_SETTLE);
+
+	SystemCmd cmd(cmd_line);
+	if (cmd.retcode() != 0)
+	    ST_THROW(Exception("create partition failed"));
+    }
+
+
+    string
+    Partition::Impl::get_parted_create_commands() const
+    {
+	const PartitionTable* partition_table = get_partition_table();
+
+	string cmd_line = "unit s mkpart ";
 
 	if (is_msdos(partition_table))
 	    cmd_line += toString(get_type()) + " ";
@@ -677,11 +691,7 @@ namespace storage
 	else
 	    cmd_line += to_string(get_region().get_start()) + " " + to_string(get_region().get_end());
 
-	SystemCmd(UDEVADMBIN_SETTLE);
-
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("create partition failed"));
+	return cmd_line;
     }
 
 
@@ -747,10 +757,22 @@ namespace storage
     Partition::Impl::do_set_id() const
     {
 	const Partitionable* partitionable = get_partitionable();
+
+	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " " +
+	    get_parted_set_id_commands();
+
+	SystemCmd cmd(cmd_line);
+	if (cmd.retcode() != 0)
+	    ST_THROW(Exception("set partition id failed"));
+    }
+
+
+    string
+    Partition::Impl::get_parted_set_id_commands() const
+    {
 	const PartitionTable* partition_table = get_partition_table();
 
-	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " set " +
-	    to_string(get_number()) + " ";
+	string cmd_line = "set " + to_string(get_number()) + " ";
 
 	if (is_msdos(partition_table))
 	{
@@ -792,22 +814,20 @@ namespace storage
 		    break;
 
 		case ID_WINDOWS_BASIC_DATA:
-		    cmd_line += "msftdata";
+		    cmd_line += "msftdata on";
 		    break;
 
 		case ID_MICROSOFT_RESERVED:
-		    cmd_line += "msftres";
+		    cmd_line += "msftres on";
 		    break;
 
 		case ID_DIAG:
-		    cmd_line += "diag";
+		    cmd_line += "diag on";
 		    break;
 	    }
 	}
 
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("set partition id failed"));
+	return cmd_line;
     }
 
 
@@ -842,8 +862,8 @@ namespace storage
     {
 	const Partitionable* partitionable = get_partitionable();
 
-	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " set " +
-	    to_string(get_number()) + " boot " + (is_boot() ? "on" : "off");
+	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " " +
+	    get_parted_set_boot_commands();
 
 	SystemCmd cmd(cmd_line);
 	if (cmd.retcode() != 0)
@@ -851,6 +871,13 @@ namespace storage
     }
 
 
+    string
+    Partition::Impl::get_parted_set_boot_commands() const
+    {
+	return "set " + to_string(get_number()) + " boot " + (is_boot() ? "on" : "off");
+    }
+
+
     Text
     Partition::Impl::do_set_legacy_boot_text(Tense tense) const
     {
@@ -882,8 +909,8 @@ namespace storage
     {
 	const Partitionable* partitionable = get_partitionable();
 
-	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " set " +
-	    to_string(get_number()) + " legacy_boot " + (is_legacy_boot() ? "on" : "off");
+	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " " +
+	    get_parted_set_legacy_boot_commands();
 
 	SystemCmd cmd(cmd_line);
 	if (cmd.retcode() != 0)
@@ -891,6 +918,13 @@ namespace storage
     }
 
 
+    string
+    Partition::Impl::get_parted_set_legacy_boot_commands() const
+    {
+	return "set " + to_string(get_number()) + " legacy_boot " + (is_legacy_boot() ? "on" : "off");
+    }
+
+
     Text
     Partition::Impl::do_delete_text(Tense tense) const
     {
@@ -973,8 +1007,8 @@ namespace storage
 
 	const Partitionable* partitionable = get_partitionable();
 
-	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " rm " +
-	    to_string(get_number());
+	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " " +
+	    get_parted_delete_commands();
 
 	SystemCmd cmd(cmd_line);
 	if (cmd.retcode() != 0)
@@ -982,6 +1016,13 @@ namespace storage
     }
 
 
+    string
+    Partition::Impl::get_parted_delete_commands() const
+    {
+	return "rm " + to_string(get_number());
+    }
+
+
     void
     Partition::Impl::do_delete_efi_boot_mgr() const
     {
@@ -1053,12 +1094,26 @@ namespace storage
     void
     Partition::Impl::do_resize(ResizeMode resize_mode, const Device* rhs) const
     {
-	const Partition* partition_rhs = to_partition(rhs);
 	const Partitionable* partitionable = get_partitionable();
+
+	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " " +
+	    get_parted_resize_commands(rhs);
+
+	wait_for_devices({ get_non_impl() });
+
+	SystemCmd cmd(cmd_line);
+	if (cmd.retcode() != 0)
+	    ST_THROW(Exception("resize partition failed"));
+    }
+
+
+    string
+    Partition::Impl::get_parted_resize_commands(const Device* rhs) const
+    {
+	const Partition* partition_rhs = to_partition(rhs);
 	const PartitionTable* partition_table = get_partition_table();
 
-	string cmd_line = PARTEDBIN " --script " + quote(partitionable->get_name()) + " unit s "
-	    "resizepart " + to_string(get_number()) + " ";
+	string cmd_line = "unit s resizepart " + to_string(get_number()) + " ";
 
 	// See fix_dasd_sector_size() in class Parted.
 	if (is_dasd_pt(partition_table) && get_region().get_block_size() == 4096)
@@ -1066,11 +1121,7 @@ namespace storage
 	else
 	    cmd_line += to_string(partition_rhs->get_region().get_end());
 
-	wait_for_devices({ get_non_impl() });
-
-	SystemCmd cmd(cmd_line);
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("resize partition failed"));
+	return cmd_line;
     }
 
 
@@ -1127,6 +1178,98 @@ namespace storage
     }
 
 
+    const Partition*
+    get_parted_batch_partition(const Action::Base* action, const Actiongraph::Impl& actiongraph)
+    {
+	if (action->nop)
+	    return nullptr;
+
+	const Device* device = nullptr;
+
+	if (is_create(action))
+	    device = actiongraph.get_devicegraph(RHS)->find_device(action->sid);
+	else if (is_delete(action))
+	    device = actiongraph.get_devicegraph(LHS)->find_device(action->sid);
+	else if (is_action_of_type<const Action::SetPartitionId>(action) ||
+		 is_action_of_type<const Action::SetBoot>(action) ||
+		 is_action_of_type<const Action::SetLegacyBoot>(action))
+	    device = actiongraph.get_devicegraph(RHS)->find_device(action->sid);
+	else if (is_action_of_type<const Action::Resize>(action))
+	    device = actiongraph.get_devicegraph(dynamic_cast<const Action::Resize*>(action)->get_side())->
+		find_device(action->sid);
+
+	if (!device || !is_partition(device))
+	    return nullptr;
+
+	return to_partition(device);
+    }
+
+
+    void
+    commit_parted_batch(const vector<const Action::Base*>& actions, const Actiongraph::Impl& actiongraph)
+    {
+	const Partitionable* partitionable = nullptr;
+
+	bool create = false;
+	string commands;
+
+	for (const Action::Base* action : actions)
+	{
+	    const Partition* partition = get_parted_batch_partition(action, actiongraph);
+	    if (!partition)
+		ST_THROW(LogicException("action cannot be committed with parted batch"));
+
+	    if (!partitionable)
+		partitionable = partition->get_partitionable();
+
+	    const Partition::Impl& impl = partition->get_impl();
+
+	    // The preparations done by the do_* functions are done here
+	    // before the single parted run.
+
+	    if (is_create(action))
+	    {
+		create = true;
+		commands += " " + impl.get_parted_create_commands();
+	    }
+	    else if (is_delete(action))
+	    {
+		impl.do_delete_efi_boot_mgr();
+		commands += " " + impl.get_parted_delete_commands();
+	    }
+	    else if (is_action_of_type<const Action::SetPartitionId>(action))
+	    {
+		commands += " " + impl.get_parted_set_id_commands();
+	    }
+	    else if (is_action_of_type<const Action::SetBoot>(action))
+	    {
+		commands += " " + impl.get_parted_set_boot_commands();
+	    }
+	    else if (is_action_of_type<const Action::SetLegacyBoot>(action))
+	    {
+		commands += " " + impl.get_parted_set_legacy_boot_commands();
+	    }
+	    else
+	    {
+		const Device* rhs = actiongraph.get_devicegraph(RHS)->find_device(action->sid);
+
+		wait_for_devices({ partition });
+		commands += " " + impl.get_parted_resize_commands(rhs);
+	    }
+	}
+
+	string cmd_line = PARTEDBIN " --script " + string(create ? "--wipesignatures " : "") +
+	    quote(partitionable->get_name()) + commands;
+
+	if (create)
+	    SystemCmd(UDEVADMBIN_SETTLE);
+
+	SystemCmd cmd(cmd_line);
+	if (cmd.retcode() != 0)
+	    ST_THROW(Exception("partitioning failed"));
+    }
+
+
     unsigned int
     Partition::Impl::default_id_for_type(PartitionType type)
     {
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -135,6 +135,18 @@ namespace storage
 
 	static unsigned int default_id_for_type(PartitionType type);
 
+	/**
+	 * Return the parted commands used by the do_* functions. The
+	 * commands for several partitions of one partitionable can be
+	 * combined in one parted run, see commit_parted_batch().
+	 */
+	string get_parted_create_commands() const;
+	string get_parted_set_id_commands() const;
+	string get_parted_set_boot_commands() const;
+	string get_parted_set_legacy_boot_commands() const;
+	string get_parted_delete_commands() const;
+	string get_parted_resize_commands(const Device* rhs) const;
+
     private:
 
 	PartitionType type;
@@ -188,6 +200,22 @@ namespace storage
 
     string id_to_string(unsigned int id);
 
+
+    /**
+     * Returns the partition the action works on if the action only runs
+     * parted and can thus be committed together with other such actions
+     * on the same partitionable, otherwise nullptr.
+     */
+    const Partition* get_parted_batch_partition(const Action::Base* action,
+						const Actiongraph::Impl& actiongraph);
+
+    /**
+     * Commits the actions, all on partitions of the same partitionable
+     * and accepted by get_parted_batch_partition(), with one parted run.
+     */
+    void commit_parted_batch(const vector<const Action::Base*>& actions,
+			     const Actiongraph::Impl& actiongraph);
+
 }
 
 #endif
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -112,6 +113,20 @@ namespace storage
     }
 
 
+    const string&
+    Environment::get_probe_cache_filename() const
+    {
+	return get_impl().get_probe_cache_filename();
+    }
+
+
+    void
+    Environment::set_probe_cache_filename(const string& probe_cache_filename)
+    {
+	get_impl().set_probe_cache_filename(probe_cache_filename);
+    }
+
+
     std::ostream&
     operator<<(std::ostream& out, const Environment& environment)
     {
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -75,6 +76,21 @@ namespace storage
 	const std::string& get_mockup_filename() const;
 	void set_mockup_filename(const std::string& mockup_filename);
 
+	/**
+	 * Filename of the optional probe cache. If set, probing with
+	 * ProbeMode::STANDARD or ProbeMode::STANDARD_WRITE_DEVICEGRAPH
+	 * saves the probed devicegraph there and a later probe, also by
+	 * another process, loads it instead of probing as long as no
+	 * uevent happened and /etc/fstab, /etc/crypttab, /etc/mdadm.conf
+	 * and the mounts are unchanged. Empty by default.
+	 *
+	 * Committing invalidates the cache. Changes done by other programs
+	 * not causing uevents, e.g. creating btrfs subvolumes or changing
+	 * filesystem labels of mounted filesystems, are not detected.
+	 */
+	const std::string& get_probe_cache_filename() const;
+	void set_probe_cache_filename(const std::string& probe_cache_filename);
+
 	friend std::ostream& operator<<(std::ostream& out, const Environment& environment);
 
     public:
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -60,6 +61,13 @@ namespace storage
     }
 
 
+    void
+    Environment::Impl::set_probe_cache_filename(const string& probe_cache_filename)
+    {
+	Impl::probe_cache_filename = probe_cache_filename;
+    }
+
+
     std::ostream&
     operator<<(std::ostream& out, const Environment::Impl& environment)
     {
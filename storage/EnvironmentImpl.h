@@ -1,5 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -55,6 +56,9 @@ namespace storage
 	const string& get_mockup_filename() const { return mockup_filename; }
 	void set_mockup_filename(const string& mockup_filename);
 
+	const string& get_probe_cache_filename() const { return probe_cache_filename; }
+	void set_probe_cache_filename(const string& probe_cache_filename);
+
 	bool is_debug_credentials() const { return false; }
 
 	friend std::ostream& operator<<(std::ostream& out, const Impl& environment);
@@ -67,6 +71,7 @@ namespace storage
 	string devicegraph_filename;
 	string arch_filename;
 	string mockup_filename;
+	string probe_cache_filename;
 
     };
 
@@ -27,6 +27,7 @@
 
 #include "storage/EtcCrypttab.h"
 #include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
 
 
@@ -219,6 +220,9 @@ namespace storage
     EtcCrypttab::find_by_block_device(SystemInfo& system_info, const string& uuid,
 				      const string& label, dev_t majorminor) const
     {
+	// avoids running 'udevadm info' for every entry if possible
+	const vector<string>* names = system_info.find_names_by_majorminor(majorminor);
+
 	for (int i = 0; i < get_entry_count(); ++i)
 	{
 	    const CrypttabEntry* entry = get_entry(i);
@@ -245,7 +249,8 @@ namespace storage
 
 	    if (boost::starts_with(blk_device, "/dev/"))
 	    {
-		if (system_info.getCmdUdevadmInfo(blk_device).get_majorminor() == majorminor)
+		if (names ? contains(*names, blk_device) :
+		    system_info.getCmdUdevadmInfo(blk_device).get_majorminor() == majorminor)
 		    return entry;
 	    }
 	}
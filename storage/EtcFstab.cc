@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) [2017] SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -22,6 +22,7 @@
 
 #include <stdlib.h>
 #include <regex>
+#include <set>
 #include <boost/algorithm/string.hpp>
 #include <boost/algorithm/string/classification.hpp>
 #include <boost/algorithm/string/split.hpp>
@@ -31,6 +32,7 @@
 #include "storage/Filesystems/MountPointImpl.h"
 #include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/StorageTmpl.h"
+#include "storage/SystemInfo/SystemInfo.h"
 
 
 #define FSTAB_COLUMN_COUNT	6
@@ -344,10 +346,12 @@ namespace storage
     {
 	vector<FstabEntry*> ret;
 
+	const std::set<string> tmp(devices.begin(), devices.end());
+
 	for (int i = 0; i < get_entry_count(); ++i)
 	{
 	    FstabEntry* entry = get_entry(i);
-	    if (entry && contains(devices, entry->get_device()))
+	    if (entry && tmp.count(entry->get_device()) != 0)
 		ret.push_back(entry);
 	}
 
@@ -360,10 +364,12 @@ namespace storage
     {
 	vector<const FstabEntry*> ret;
 
+	const std::set<string> tmp(devices.begin(), devices.end());
+
 	for (int i = 0; i < get_entry_count(); ++i)
 	{
 	    FstabEntry* entry = get_entry(i);
-	    if (entry && contains(devices, entry->get_device()))
+	    if (entry && tmp.count(entry->get_device()) != 0)
 		ret.push_back(entry);
 	}
 
@@ -578,6 +584,28 @@ namespace storage
     }
 
 
+    vector<string>
+    EtcFstab::construct_device_aliases(SystemInfo& system_info, const BlkDevice* blk_device,
+				       const BlkFilesystem* blk_filesystem)
+    {
+	vector<string> device_aliases = construct_device_aliases(blk_device, blk_filesystem);
+
+	dev_t majorminor = system_info.getCmdUdevadmInfo(blk_device->get_name()).get_majorminor();
+
+	const vector<string>* names = system_info.find_names_by_majorminor(majorminor);
+	if (names)
+	{
+	    for (const string& name : *names)
+	    {
+		if (!contains(device_aliases, name))
+		    device_aliases.push_back(name);
+	    }
+	}
+
+	return device_aliases;
+    }
+
+
     string
     JointEntry::get_mount_point() const
     {
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2014] Novell, Inc.
- * Copyright (c) [2017] SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -42,6 +42,7 @@ namespace storage
 
     class BlkDevice;
     class BlkFilesystem;
+    class SystemInfo;
 
 
     /**
@@ -395,6 +396,15 @@ namespace storage
 	static vector<string> construct_device_aliases(const BlkDevice* blk_device,
 						       const BlkFilesystem* blk_filesystem);
 
+	/**
+	 * Like above but additionally includes all names of the block
+	 * device from the udev database, e.g. /dev/dm-0 or
+	 * /dev/mapper/system-root, if available.
+	 */
+	static vector<string> construct_device_aliases(SystemInfo& system_info,
+						       const BlkDevice* blk_device,
+						       const BlkFilesystem* blk_filesystem);
+
     protected:
 
         /**
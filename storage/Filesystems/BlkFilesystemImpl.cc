@@ -160,7 +160,7 @@ namespace storage
 
 	const BlkDevice* blk_device = get_blk_device();
 
-	vector<string> aliases = EtcFstab::construct_device_aliases(blk_device, get_non_impl());
+	vector<string> aliases = EtcFstab::construct_device_aliases(system_info, blk_device, get_non_impl());
 
 	vector<const FstabEntry*> fstab_entries = find_etc_fstab_entries(system_info.getEtcFstab(), aliases);
 	vector<const FstabEntry*> mount_entries = find_proc_mounts_entries(system_info, aliases);
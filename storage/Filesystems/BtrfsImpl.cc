@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -245,6 +245,10 @@ namespace storage
 	BtrfsSubvolume* top_level = get_top_level_btrfs_subvolume();
 	subvolumes_by_id[top_level->get_id()] = top_level;
 
+	// The top-level subvolume is mounted once here for listing the
+	// subvolumes, getting the default subvolume and the nocow
+	// attributes. The mount is released at the end of this function.
+
 	unique_ptr<EnsureMounted> ensure_mounted;
 	string mount_point = "/tmp/does-not-matter";
 	if (Mockup::get_mode() != Mockup::Mode::PLAYBACK)
@@ -294,21 +298,15 @@ namespace storage
     {
 	BlkFilesystem::Impl::probe_pass_2b(prober);
 
-	BtrfsSubvolume* top_level = get_top_level_btrfs_subvolume();
-
-	unique_ptr<EnsureMounted> ensure_mounted;
-	string mount_point = "/tmp/does-not-matter";
-	if (Mockup::get_mode() != Mockup::Mode::PLAYBACK)
-	{
-	    ensure_mounted.reset(new EnsureMounted(top_level));
-	    mount_point = ensure_mounted->get_any_mount_point();
-	}
+	// Only fstab and mount entries are probed here, so no mount is
+	// needed. A temporary mount must not exist here anyway since it
+	// would show up in /proc/mounts.
 
 	vector<BtrfsSubvolume*> btrfs_subvolumes = get_btrfs_subvolumes();
 	sort(btrfs_subvolumes.begin(), btrfs_subvolumes.end(), BtrfsSubvolume::compare_by_id);
 	for (BtrfsSubvolume* btrfs_subvolume : btrfs_subvolumes)
 	{
-	    btrfs_subvolume->get_impl().probe_pass_2b(prober, mount_point);
+	    btrfs_subvolume->get_impl().probe_pass_2b(prober);
 	}
     }
 
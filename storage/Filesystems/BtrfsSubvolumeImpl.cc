@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -273,14 +273,14 @@ namespace storage
 
 
     void
-    BtrfsSubvolume::Impl::probe_pass_2b(Prober& prober, const string& mount_point)
+    BtrfsSubvolume::Impl::probe_pass_2b(Prober& prober)
     {
 	SystemInfo& system_info = prober.get_system_info();
 
 	const Btrfs* btrfs = get_btrfs();
 	const BlkDevice* blk_device = btrfs->get_impl().get_blk_device();
 
-	vector<string> aliases = EtcFstab::construct_device_aliases(blk_device, btrfs);
+	vector<string> aliases = EtcFstab::construct_device_aliases(system_info, blk_device, btrfs);
 
 	vector<const FstabEntry*> fstab_entries = find_etc_fstab_entries(system_info.getEtcFstab(), aliases);
 	vector<const FstabEntry*> mount_entries = find_proc_mounts_entries(system_info, aliases);
@@ -301,9 +301,15 @@ namespace storage
 	const Btrfs* btrfs = get_btrfs();
 	const BlkDevice* blk_device = btrfs->get_impl().get_blk_device();
 
-	const CmdBtrfsSubvolumeList& cmd_btrfs_subvolume_list =
-	    CmdBtrfsSubvolumeList(blk_device->get_name(), mount_point);
+	const CmdBtrfsSubvolumeList cmd_btrfs_subvolume_list(blk_device->get_name(), mount_point);
 
+	set_id_from(cmd_btrfs_subvolume_list);
+    }
+
+
+    void
+    BtrfsSubvolume::Impl::set_id_from(const CmdBtrfsSubvolumeList& cmd_btrfs_subvolume_list)
+    {
 	CmdBtrfsSubvolumeList::const_iterator it = cmd_btrfs_subvolume_list.find_entry_by_path(path);
 	if (it != cmd_btrfs_subvolume_list.end())
 	    id = it->id;
@@ -442,11 +448,18 @@ namespace storage
 	// e.g. when creating <fs-tree>/a/b it is enough when subvol=a is
 	// mounted somewhere.
 
-	// TODO Just do one mount if several subvolumes get created.
-
 	EnsureMounted ensure_mounted(top_level, false);
 
-	string full_path = ensure_mounted.get_any_mount_point() + "/" + path;
+	create_subvolume(ensure_mounted.get_any_mount_point());
+
+	probe_id(ensure_mounted.get_any_mount_point());
+    }
+
+
+    void
+    BtrfsSubvolume::Impl::create_subvolume(const string& mount_point) const
+    {
+	string full_path = mount_point + "/" + path;
 	string full_dirname = dirname(full_path);
 
 	if (access(full_dirname.c_str(), R_OK) != 0)
@@ -457,8 +470,6 @@ namespace storage
 	SystemCmd cmd(cmd_line);
 	if (cmd.retcode() != 0)
 	    ST_THROW(Exception("create BtrfsSubvolume failed"));
-
-	probe_id(ensure_mounted.get_any_mount_point());
     }
 
 
@@ -656,6 +667,97 @@ namespace storage
     }
 
 
+    const BtrfsSubvolume*
+    get_btrfs_subvolume_batch_subvolume(const Action::Base* action, const Actiongraph::Impl& actiongraph)
+    {
+	if (action->nop)
+	    return nullptr;
+
+	if (!is_create(action) && !is_action_of_type<const Action::SetNocow>(action))
+	    return nullptr;
+
+	const Device* device = actiongraph.get_devicegraph(RHS)->find_device(action->sid);
+	if (!is_btrfs_subvolume(device))
+	    return nullptr;
+
+	const BtrfsSubvolume* btrfs_subvolume = to_btrfs_subvolume(device);
+	if (btrfs_subvolume->get_impl().is_top_level())
+	    return nullptr;
+
+	return btrfs_subvolume;
+    }
+
+
+    void
+    commit_btrfs_subvolume_batch(const vector<const Action::Base*>& actions,
+				 const Actiongraph::Impl& actiongraph)
+    {
+	const Btrfs* btrfs = nullptr;
+
+	for (const Action::Base* action : actions)
+	{
+	    const BtrfsSubvolume* btrfs_subvolume = get_btrfs_subvolume_batch_subvolume(action, actiongraph);
+	    if (!btrfs_subvolume || (btrfs && btrfs_subvolume->get_btrfs() != btrfs))
+		ST_THROW(LogicException("action cannot be committed with btrfs subvolume batch"));
+
+	    btrfs = btrfs_subvolume->get_btrfs();
+	}
+
+	if (!btrfs)
+	    return;
+
+	EnsureMounted ensure_mounted(btrfs->get_top_level_btrfs_subvolume(), false);
+
+	const string mount_point = ensure_mounted.get_any_mount_point();
+
+	// Subvolumes are created in the order of the actions so that
+	// parents are created before children. Setting nocow is done
+	// afterwards for all subvolumes at once.
+
+	vector<BtrfsSubvolume*> created;
+	map<bool, vector<string>> nocow_paths;
+
+	for (const Action::Base* action : actions)
+	{
+	    BtrfsSubvolume* btrfs_subvolume =
+		to_btrfs_subvolume(actiongraph.get_devicegraph_rhs()->find_device(action->sid));
+
+	    if (is_create(action))
+	    {
+		btrfs_subvolume->get_impl().create_subvolume(mount_point);
+		created.push_back(btrfs_subvolume);
+	    }
+	    else
+	    {
+		nocow_paths[btrfs_subvolume->is_nocow()].push_back(mount_point + "/" +
+								   btrfs_subvolume->get_path());
+	    }
+	}
+
+	for (const map<bool, vector<string>>::value_type& value : nocow_paths)
+	{
+	    string cmd_line = CHATTRBIN " " + string(value.first ? "+" : "-") + "C";
+
+	    for (const string& path : value.second)
+		cmd_line += " " + quote(path);
+
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("set nocow failed"));
+	}
+
+	if (!created.empty())
+	{
+	    const BlkDevice* blk_device = btrfs->get_impl().get_blk_device();
+
+	    const CmdBtrfsSubvolumeList cmd_btrfs_subvolume_list(blk_device->get_name(), mount_point);
+
+	    for (BtrfsSubvolume* btrfs_subvolume : created)
+		btrfs_subvolume->get_impl().set_id_from(cmd_btrfs_subvolume_list);
+	}
+    }
+
+
     namespace Action
     {
 
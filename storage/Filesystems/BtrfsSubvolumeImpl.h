@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -35,6 +35,7 @@ namespace storage
 
 
     class EtcFstab;
+    class CmdBtrfsSubvolumeList;
 
 
     template <> struct DeviceTraits<BtrfsSubvolume> { static const char* classname; };
@@ -59,7 +60,7 @@ namespace storage
 	virtual Impl* clone() const override { return new Impl(*this); }
 
 	virtual void probe_pass_2a(Prober& prober, const string& mount_point);
-	virtual void probe_pass_2b(Prober& prober, const string& mount_point);
+	virtual void probe_pass_2b(Prober& prober);
 
 	long get_id() const { return id; }
 	void set_id(long id) { Impl::id = id; }
@@ -123,6 +124,18 @@ namespace storage
 
 	virtual Text do_remove_from_etc_fstab_text(const MountPoint* mount_point, Tense tense) const override;
 
+	/**
+	 * Creates the subvolume, including missing parent directories,
+	 * with the top-level subvolume mounted at mount_point. Does not
+	 * probe the id.
+	 */
+	void create_subvolume(const string& mount_point) const;
+
+	/**
+	 * Sets the id from the subvolume list, see probe_id().
+	 */
+	void set_id_from(const CmdBtrfsSubvolumeList& cmd_btrfs_subvolume_list);
+
 	virtual Text do_set_nocow_text(Tense tense) const;
 	virtual void do_set_nocow() const;
 
@@ -149,6 +162,25 @@ namespace storage
     };
 
 
+    /**
+     * Returns the subvolume the action works on if the action only
+     * creates the subvolume or sets nocow and can thus be committed
+     * together with other such actions on the same btrfs, otherwise
+     * nullptr.
+     */
+    const BtrfsSubvolume* get_btrfs_subvolume_batch_subvolume(const Action::Base* action,
+							      const Actiongraph::Impl& actiongraph);
+
+    /**
+     * Commits the actions, all on subvolumes of the same btrfs and
+     * accepted by get_btrfs_subvolume_batch_subvolume(), with one
+     * temporary mount of the top-level subvolume, one chattr run per
+     * nocow setting and one subvolume list to probe the ids.
+     */
+    void commit_btrfs_subvolume_batch(const vector<const Action::Base*>& actions,
+				      const Actiongraph::Impl& actiongraph);
+
+
     namespace Action
     {
 
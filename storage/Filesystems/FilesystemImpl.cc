@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -30,7 +30,7 @@
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/Devicegraph.h"
-#include "storage/SystemInfo/SystemInfo.h"
+#include "storage/SystemInfo/CmdDf.h"
 #include "storage/StorageImpl.h"
 #include "storage/FreeInfo.h"
 
@@ -104,8 +104,7 @@ namespace storage
     {
 	EnsureMounted ensure_mounted(get_filesystem());
 
-	SystemInfo system_info;
-	const CmdDf& cmd_df = system_info.getCmdDf(ensure_mounted.get_any_mount_point());
+	CmdDf cmd_df(ensure_mounted.get_any_mount_point());
 
 	return cmd_df.get_space_info();
     }
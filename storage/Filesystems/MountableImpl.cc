@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -32,6 +32,8 @@
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Filesystems/FilesystemImpl.h"
 #include "storage/Filesystems/MountPointImpl.h"
+#include "storage/Filesystems/BtrfsSubvolumeImpl.h"
+#include "storage/Filesystems/Btrfs.h"
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/Holders/User.h"
 #include "storage/Devicegraph.h"
@@ -405,11 +407,40 @@ namespace storage
 
 	const Storage* storage = mountable->get_impl().get_storage();
 
+	TmpMountCache& tmp_mount_cache = storage->get_impl().get_tmp_mount_cache();
+
+	if (tmp_mount_cache.is_enabled())
+	{
+	    tmp_mount = tmp_mount_cache.find(mountable->get_sid(), read_only);
+	    if (tmp_mount)
+	    {
+		y2mil("EnsureMounted using cached tmp mount " << tmp_mount->get_fullname());
+		return;
+	    }
+
+	    // A cached read-only mount must be unmounted before mounting
+	    // read-write.
+	    tmp_mount_cache.erase(mountable->get_sid());
+	}
+
 	mountable->get_impl().wait_for_devices();
 
-	tmp_mount.reset(new TmpMount(storage->get_impl().get_tmp_dir().get_fullname(),
-				     "tmp-mount-XXXXXX", mountable->get_impl().get_mount_name(),
-				     read_only, mountable->get_impl().get_mount_options()));
+	tmp_mount = make_shared<TmpMount>(storage->get_impl().get_tmp_dir().get_fullname(),
+					  "tmp-mount-XXXXXX", mountable->get_impl().get_mount_name(),
+					  read_only, mountable->get_impl().get_mount_options());
+
+	if (tmp_mount_cache.is_enabled())
+	    tmp_mount_cache.insert(mountable->get_sid(), filesystem_sid(mountable), read_only, tmp_mount);
+    }
+
+
+    sid_t
+    EnsureMounted::filesystem_sid(const Mountable* mountable)
+    {
+	if (is_btrfs_subvolume(mountable))
+	    return to_btrfs_subvolume(mountable)->get_btrfs()->get_sid();
+
+	return mountable->get_sid();
     }
 
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -153,6 +153,9 @@ namespace storage
 	 * Ensures that the blk mountable is mounted somewhere.
 	 *
 	 * The mode is not enforced.
+	 *
+	 * During probe and commit temporary mounts are kept in the
+	 * TmpMountCache of the storage object and reused.
 	 */
 	EnsureMounted(const Mountable* mountable, bool read_only = true);
 
@@ -165,9 +168,15 @@ namespace storage
 
 	bool mountable_has_active_mount_point() const;
 
+	/**
+	 * Returns the sid of the filesystem the mountable belongs to, for
+	 * btrfs subvolumes the sid of the btrfs.
+	 */
+	static sid_t filesystem_sid(const Mountable* mountable);
+
 	const Mountable* mountable;
 
-	unique_ptr<TmpMount> tmp_mount;
+	shared_ptr<TmpMount> tmp_mount;
 
     };
 
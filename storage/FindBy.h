@@ -35,14 +35,19 @@ namespace storage
     using std::string;
 
 
+    // The lookups use the name and uuid indexes of the devicegraph, see
+    // Devicegraph::Impl::find_vertices_by_name() and
+    // Devicegraph::Impl::find_vertices_by_uuid().
+
+
     template<typename Type>
     Type*
     find_by_name(Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
+	    if (device)
 		return device;
 	}
 
@@ -54,10 +59,10 @@ namespace storage
     const Type*
     find_by_name(const Devicegraph* devicegraph, const string& name)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_name(name))
 	{
 	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_name() == name)
+	    if (device)
 		return device;
 	}
 
@@ -69,10 +74,10 @@ namespace storage
     Type*
     find_by_uuid(Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
 	    Type* device = dynamic_cast<Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
+	    if (device)
 		return device;
 	}
 
@@ -84,10 +89,10 @@ namespace storage
     const Type*
     find_by_uuid(const Devicegraph* devicegraph, const string& uuid)
     {
-	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().vertices())
+	for (Devicegraph::Impl::vertex_descriptor vertex : devicegraph->get_impl().find_vertices_by_uuid(uuid))
 	{
 	    const Type* device = dynamic_cast<const Type*>(devicegraph->get_impl()[vertex]);
-	    if (device && device->get_impl().get_uuid() == uuid)
+	    if (device)
 		return device;
 	}
 
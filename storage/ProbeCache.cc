@@ -0,0 +1,208 @@
+/*
+ * Copyright (c) 2018 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#include <sys/stat.h>
+#include <unistd.h>
+#include <stdio.h>
+#include <fstream>
+#include <sstream>
+#include <functional>
+
+#include "config.h"
+#include "storage/ProbeCache.h"
+#include "storage/Devicegraph.h"
+#include "storage/EtcFstab.h"
+#include "storage/EtcCrypttab.h"
+#include "storage/EtcMdadm.h"
+#include "storage/SystemInfo/Arch.h"
+#include "storage/Utils/XmlFile.h"
+#include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
+
+
+namespace storage
+{
+
+    namespace
+    {
+
+	string
+	read_file(const string& name)
+	{
+	    std::ifstream file(name);
+	    std::ostringstream content;
+	    content << file.rdbuf();
+	    return content.str();
+	}
+
+
+	string
+	modification_time(const string& name)
+	{
+	    struct stat buf;
+	    if (stat(name.c_str(), &buf) != 0)
+		return "none";
+
+	    return std::to_string(buf.st_mtim.tv_sec) + "." + std::to_string(buf.st_mtim.tv_nsec);
+	}
+
+    }
+
+
+    ProbeCache::ProbeCache(const string& filename)
+	: filename(filename), key(calculate_key())
+    {
+	y2mil("probe cache key:" << key);
+    }
+
+
+    string
+    ProbeCache::calculate_key()
+    {
+	// Mounting and unmounting do not cause uevents.
+
+	string mounts = read_file("/proc/self/mountinfo");
+
+	string seqnum = read_file("/sys/kernel/uevent_seqnum");
+	if (!seqnum.empty() && seqnum.back() == '\n')
+	    seqnum.pop_back();
+
+	return "version:" VERSION " seqnum:" + seqnum + " fstab:" + modification_time(ETC_FSTAB) +
+	    " crypttab:" + modification_time(ETC_CRYPTTAB) + " mdadm:" + modification_time(ETC_MDADM) +
+	    " mounts:" + std::to_string(std::hash<string>()(mounts));
+    }
+
+
+    bool
+    ProbeCache::load(Devicegraph* devicegraph, Arch& arch) const
+    {
+	const string key_filename = filename + ".key";
+
+	if (access(key_filename.c_str(), R_OK) != 0)
+	{
+	    y2mil("probe cache not found");
+	    return false;
+	}
+
+	try
+	{
+	    XmlFile xml(key_filename);
+
+	    const xmlNode* root_node = xml.getRootElement();
+	    if (!root_node)
+		ST_THROW(Exception("root node not found"));
+
+	    const xmlNode* probe_cache_node = getChildNode(root_node, "ProbeCache");
+	    if (!probe_cache_node)
+		ST_THROW(Exception("ProbeCache node not found"));
+
+	    string cached_key;
+	    getChildValue(probe_cache_node, "key", cached_key);
+
+	    if (cached_key != key)
+	    {
+		y2mil("probe cache outdated, key:" << cached_key);
+		return false;
+	    }
+
+	    const xmlNode* arch_node = getChildNode(probe_cache_node, "Arch");
+	    if (!arch_node)
+		ST_THROW(Exception("Arch node not found"));
+
+	    arch.readData(arch_node);
+
+	    devicegraph->load(filename);
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    y2err("loading probe cache failed");
+
+	    devicegraph->clear();
+
+	    return false;
+	}
+
+	y2mil("probe cache loaded");
+
+	return true;
+    }
+
+
+    void
+    ProbeCache::save(const Devicegraph* devicegraph, const Arch& arch) const
+    {
+	const string key_filename = filename + ".key";
+
+	// The key file is removed first and written last so that a
+	// concurrent load never sees a new key with an old devicegraph.
+
+	unlink(key_filename.c_str());
+
+	XmlFile xml;
+
+	xmlNode* probe_cache_node = xmlNewNode("ProbeCache");
+	xml.setRootElement(probe_cache_node);
+
+	setChildValue(probe_cache_node, "key", key);
+
+	xmlNode* arch_node = xmlNewChild(probe_cache_node, "Arch");
+	arch.saveData(arch_node);
+
+	try
+	{
+	    devicegraph->save(filename + ".tmp");
+	}
+	catch (const Exception& exception)
+	{
+	    ST_CAUGHT(exception);
+
+	    y2err("saving probe cache failed");
+
+	    return;
+	}
+
+	xml.save(key_filename + ".tmp");
+
+	if (rename((filename + ".tmp").c_str(), filename.c_str()) != 0 ||
+	    rename((key_filename + ".tmp").c_str(), key_filename.c_str()) != 0)
+	{
+	    y2err("saving probe cache failed");
+	    return;
+	}
+
+	y2mil("probe cache saved");
+    }
+
+
+    void
+    ProbeCache::invalidate(const string& filename)
+    {
+	const string key_filename = filename + ".key";
+
+	if (unlink(key_filename.c_str()) == 0)
+	    y2mil("probe cache invalidated");
+    }
+
+}
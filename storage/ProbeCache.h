@@ -0,0 +1,88 @@
+/*
+ * Copyright (c) 2018 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+
+#ifndef STORAGE_PROBE_CACHE_H
+#define STORAGE_PROBE_CACHE_H
+
+
+#include <string>
+
+
+namespace storage
+{
+    using std::string;
+
+
+    class Devicegraph;
+    class Arch;
+
+
+    /**
+     * On-disk cache of the probed devicegraph, see
+     * Environment::set_probe_cache_filename(). The devicegraph is saved
+     * in the file, the key and the arch in the file with ".key" appended.
+     *
+     * The key is calculated when the object is constructed, so before
+     * probing. Thus changes during probing invalidate the cache.
+     */
+    class ProbeCache
+    {
+    public:
+
+	ProbeCache(const string& filename);
+
+	/**
+	 * Loads the devicegraph and the arch if the cache is valid. Returns
+	 * false otherwise, also if loading fails.
+	 */
+	bool load(Devicegraph* devicegraph, Arch& arch) const;
+
+	/**
+	 * Saves the devicegraph and the arch. Errors are only logged.
+	 */
+	void save(const Devicegraph* devicegraph, const Arch& arch) const;
+
+	/**
+	 * Removes the key file so that the cache is not used anymore. Used
+	 * when committing since some actions, e.g. creating btrfs
+	 * subvolumes, change nothing the key is calculated from.
+	 */
+	static void invalidate(const string& filename);
+
+	/**
+	 * Calculates the key from /sys/kernel/uevent_seqnum, the
+	 * modification times of /etc/fstab, /etc/crypttab and
+	 * /etc/mdadm.conf and a hash of the mounts.
+	 */
+	static string calculate_key();
+
+    private:
+
+	const string filename;
+	const string key;
+
+    };
+
+}
+
+#endif
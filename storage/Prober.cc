@@ -21,6 +21,8 @@
  */
 
 
+#include <boost/algorithm/string.hpp>
+
 #include "storage/Prober.h"
 #include "storage/Devices/BlkDeviceImpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
@@ -41,13 +43,19 @@
 #include "storage/Filesystems/BlkFilesystemImpl.h"
 #include "storage/Filesystems/NfsImpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
+#include "storage/Devices/PartitionableImpl.h"
+#include "storage/Utils/ThreadPool.h"
+#include "storage/Utils/Remote.h"
+#include "storage/Utils/StorageTmpl.h"
+#include "storage/Utils/ExceptionImpl.h"
+#include "storage/Utils/LoggerImpl.h"
 
 
 namespace storage
 {
 
     Prober::Prober(Devicegraph* probed, SystemInfo& system_info)
-	: probed(probed), system_info(system_info)
+	: probed(probed), system_info(system_info), num_threads(probe_threads())
     {
 	/**
 	 * Difficulties:
@@ -82,8 +90,18 @@ namespace storage
 	 * Pass 1e: Probe some remaining attributes.
 	 *
 	 * Pass 2:  Probe filesystems and mount points.
+	 *
+	 * Optionally the external commands are prefetched in parallel
+	 * before pass 1a and pass 1c.
 	 */
 
+	if (num_threads > 1)
+	{
+	    y2mil("prober prefetch with " << num_threads << " threads");
+
+	    prefetch_pass_1a();
+	}
+
 	// Pass 1a
 
 	y2mil("prober pass 1a");
@@ -142,6 +160,9 @@ namespace storage
 
 	// Pass 1c
 
+	if (num_threads > 1)
+	    prefetch_pass_1c();
+
 	y2mil("prober pass 1c");
 
 	for (Devicegraph::Impl::vertex_descriptor vertex : probed->get_impl().vertices())
@@ -203,6 +224,154 @@ namespace storage
     }
 
 
+    unsigned int
+    Prober::probe_threads()
+    {
+	// Remote callbacks are usually implemented in the bindings and not
+	// thread-safe.
+	if (get_remote_callbacks())
+	    return 1;
+
+	const char* tenv = getenv("LIBSTORAGE_PROBE_THREADS");
+	if (!tenv)
+	    return 1;
+
+	unsigned int ret = 1;
+	string(tenv) >> ret;
+
+	return max(ret, 1U);
+    }
+
+
+    void
+    Prober::prefetch(const vector<std::function<void()>>& tasks) const
+    {
+	vector<ThreadPool::task_t> ignoring_tasks;
+
+	for (const std::function<void()>& task : tasks)
+	{
+	    ignoring_tasks.push_back([task]() {
+		try
+		{
+		    task();
+		}
+		catch (const Exception& exception)
+		{
+		    ST_CAUGHT(exception);
+		}
+		catch (const std::exception& exception)
+		{
+		    y2war("prefetch failed: " << exception.what());
+		}
+	    });
+	}
+
+	ThreadPool::run(ignoring_tasks, num_threads);
+    }
+
+
+    void
+    Prober::prefetch_pass_1a()
+    {
+	SystemInfo& system_info = this->system_info;
+
+	prefetch({
+	    [&system_info]() { system_info.getDir(SYSFSDIR "/block"); },
+	    [&system_info]() { system_info.getBlkid(); },
+	    [&system_info]() { system_info.getCmdUdevadmDb(); },
+	    [&system_info]() { system_info.getProcMdstat(); },
+	    [&system_info]() { system_info.getCmdMultipath(); },
+	    [&system_info]() { system_info.getCmdDmraid(); },
+	    [&system_info]() { system_info.getCmdDmsetupInfo(); },
+	    [&system_info]() { system_info.getLsscsi(); }
+	});
+
+	vector<std::function<void()>> tasks;
+
+	try
+	{
+	    const Blkid& blkid = system_info.getBlkid();
+
+	    // The same names as used by the probe functions of disks, DASDs
+	    // and MDs in pass 1a.
+
+	    for (const string& short_name : system_info.getDir(SYSFSDIR "/block"))
+	    {
+		string name = DEVDIR "/" + short_name;
+
+		if (boost::starts_with(name, DEVDIR "/loop"))
+		    continue;
+
+		if (Md::Impl::is_valid_sysfs_name(name))
+		{
+		    if (blkid.any_md() && system_info.getProcMdstat().has_entry(short_name))
+			tasks.push_back([&system_info, name]() { system_info.getMdadmDetail(name); });
+		}
+		else
+		{
+		    tasks.push_back([&system_info, name]() { system_info.getCmdUdevadmInfo(name); });
+		}
+	    }
+
+	    if (blkid.any_lvm())
+	    {
+		// Only one task since with 'lvm fullreport' all three are
+		// fetched together.
+		tasks.push_back([&system_info]() {
+		    system_info.getCmdPvs();
+		    system_info.getCmdVgs();
+		    system_info.getCmdLvs();
+		});
+	    }
+
+	    if (blkid.any_luks())
+	    {
+		tasks.push_back([&system_info]() { system_info.getCmdDmsetupTable(); });
+		tasks.push_back([&system_info]() { system_info.getEtcCrypttab(); });
+
+		for (const Blkid::value_type& value : blkid)
+		{
+		    if (!value.second.is_luks)
+			continue;
+
+		    const string& name = value.first;
+		    tasks.push_back([&system_info, name]() { system_info.getCmdUdevadmInfo(name); });
+		}
+	    }
+	}
+	catch (const Exception& exception)
+	{
+	    // the serial passes will report the error
+	    ST_CAUGHT(exception);
+	}
+
+	prefetch(tasks);
+    }
+
+
+    void
+    Prober::prefetch_pass_1c()
+    {
+	SystemInfo& system_info = this->system_info;
+
+	vector<std::function<void()>> tasks;
+
+	// Same condition as in Partitionable::Impl::probe_pass_1c().
+
+	for (const Partitionable* partitionable : Partitionable::get_all(probed))
+	{
+	    if (partitionable->has_children() || !partitionable->get_impl().is_active() ||
+		partitionable->get_size() == 0)
+		continue;
+
+	    const string& name = partitionable->get_name();
+	    tasks.push_back([&system_info, name]() { system_info.getParted(name); });
+	}
+
+	prefetch(tasks);
+    }
+
+
     void
     Prober::add_holder(const string& name, Device* b, add_holder_func_t add_holder_func)
     {
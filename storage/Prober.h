@@ -42,6 +42,14 @@ namespace storage
 
     /**
      * Class for probing.
+     *
+     * If the environment variable LIBSTORAGE_PROBE_THREADS is set to a
+     * value greater than one the external commands needed for probing
+     * are prefetched and the devices are probed by libblkid in parallel
+     * using up to that many threads. The devicegraph itself is still
+     * built sequentially from the cached results, so the result is
+     * identical to serial probing. Parallel prefetching is not done with
+     * remote callbacks and requires a thread-safe logger.
      */
     class Prober
     {
@@ -65,12 +73,40 @@ namespace storage
 	 */
 	void add_holder(const string& name, Device* b, add_holder_func_t add_holder_func);
 
+	/**
+	 * Returns the number of threads to use for prefetching and other
+	 * parallel probing.
+	 */
+	static unsigned int probe_threads();
+
     private:
 
 	Devicegraph* probed;
 
 	SystemInfo& system_info;
 
+	/**
+	 * Number of threads used for prefetching. One means no prefetching.
+	 */
+	unsigned int num_threads;
+
+	/**
+	 * Runs the tasks in parallel if prefetching is enabled. Exceptions
+	 * are ignored since SystemInfo caches them and the serial passes
+	 * will see them again.
+	 */
+	void prefetch(const vector<std::function<void()>>& tasks) const;
+
+	/**
+	 * Prefetches the objects needed by pass 1a.
+	 */
+	void prefetch_pass_1a();
+
+	/**
+	 * Prefetches the objects needed by pass 1c.
+	 */
+	void prefetch_pass_1c();
+
 	struct pending_holder_t
 	{
 	    pending_holder_t(const string& name, Device* b, add_holder_func_t add_holder_func)
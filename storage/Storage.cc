@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -210,6 +210,12 @@ namespace storage
 	get_impl().probe();
     }
 
+    void
+    Storage::reprobe()
+    {
+	get_impl().reprobe();
+    }
+
     void
     Storage::commit(const CommitCallbacks* commit_callbacks)
     {
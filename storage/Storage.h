@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -285,6 +285,22 @@ namespace storage
 	 */
 	void probe();
 
+	/**
+	 * Probe the system again after commit() and replace the probed and
+	 * staging devicegraphs. The devicegraph is built from scratch and
+	 * all system-wide information, e.g. from blkid, udev, LVM, device
+	 * mapper, multipath, /proc/mounts and /proc/mdstat, is read
+	 * again. Only per-device information of devices not touched by the
+	 * actiongraphs committed since the last probe, e.g. partition
+	 * tables, btrfs subvolume lists and default subvolumes, MD details,
+	 * udev information and file attributes, is taken from the last
+	 * probe. Does a full probe if that is not possible, e.g. after a
+	 * failed commit.
+	 *
+	 * @throw Exception
+	 */
+	void reprobe();
+
 	/**
 	 * The actiongraph must be valid.
 	 *
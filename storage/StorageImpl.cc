@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -24,6 +24,7 @@
 #include "config.h"
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/LoggerImpl.h"
 #include "storage/StorageImpl.h"
 #include "storage/Devices/DiskImpl.h"
 #include "storage/Devices/DasdImpl.h"
@@ -35,11 +36,100 @@
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Actiongraph.h"
 #include "storage/Prober.h"
+#include "storage/ProbeCache.h"
+#include "storage/EnvironmentImpl.h"
 
 
 namespace storage
 {
 
+    TmpMountCache::~TmpMountCache()
+    {
+	clear();
+    }
+
+
+    TmpMountCache::Enabler::Enabler(TmpMountCache& tmp_mount_cache)
+	: tmp_mount_cache(tmp_mount_cache)
+    {
+	tmp_mount_cache.enabled = true;
+    }
+
+
+    TmpMountCache::Enabler::~Enabler()
+    {
+	tmp_mount_cache.enabled = false;
+	tmp_mount_cache.clear();
+    }
+
+
+    shared_ptr<TmpMount>
+    TmpMountCache::find(sid_t sid, bool read_only) const
+    {
+	map<sid_t, Entry>::const_iterator it = entries.find(sid);
+	if (it == entries.end() || (it->second.read_only && !read_only))
+	    return nullptr;
+
+	return it->second.tmp_mount;
+    }
+
+
+    void
+    TmpMountCache::insert(sid_t sid, sid_t filesystem_sid, bool read_only, shared_ptr<TmpMount> tmp_mount)
+    {
+	entries[sid] = { filesystem_sid, read_only, tmp_mount };
+    }
+
+
+    void
+    TmpMountCache::release_all_except(sid_t filesystem_sid)
+    {
+	// The tmp mounts are unmounted after the entries are removed since
+	// unmounting runs an external program and meanwhile another thread
+	// may use the cache (see SerialLock).
+
+	vector<shared_ptr<TmpMount>> tmp_mounts;
+
+	for (map<sid_t, Entry>::iterator it = entries.begin(); it != entries.end(); )
+	{
+	    if (it->second.filesystem_sid != filesystem_sid)
+	    {
+		tmp_mounts.push_back(it->second.tmp_mount);
+		it = entries.erase(it);
+	    }
+	    else
+	    {
+		++it;
+	    }
+	}
+    }
+
+
+    void
+    TmpMountCache::erase(sid_t sid)
+    {
+	map<sid_t, Entry>::iterator it = entries.find(sid);
+	if (it == entries.end())
+	    return;
+
+	shared_ptr<TmpMount> tmp_mount = it->second.tmp_mount;
+	entries.erase(it);
+    }
+
+
+    void
+    TmpMountCache::clear()
+    {
+	if (entries.empty())
+	    return;
+
+	y2mil("releasing " << entries.size() << " cached tmp mounts");
+
+	map<sid_t, Entry> tmp;
+	tmp.swap(entries);
+    }
+
+
     Storage::Impl::Impl(const Storage& storage, const Environment& environment)
 	: storage(storage), environment(environment), arch(false), default_mount_by(MountByType::UUID),
 	  tmp_dir("libstorage-XXXXXX")
@@ -148,6 +238,43 @@ namespace storage
 
     void
     Storage::Impl::probe()
+    {
+	system_info.reset();
+	touched_names.clear();
+
+	probe_devicegraphs();
+    }
+
+
+    void
+    Storage::Impl::reprobe()
+    {
+	if (!system_info)
+	{
+	    y2mil("reprobe not possible, doing full probe");
+	    probe();
+	    return;
+	}
+
+	system_info->invalidate(touched_names);
+	touched_names.clear();
+
+	probe_devicegraphs();
+    }
+
+
+    bool
+    Storage::Impl::probes_real_system() const
+    {
+	// With mockups all commands must be recorded or played back.
+
+	ProbeMode probe_mode = environment.get_probe_mode();
+	return probe_mode == ProbeMode::STANDARD || probe_mode == ProbeMode::STANDARD_WRITE_DEVICEGRAPH;
+    }
+
+
+    void
+    Storage::Impl::probe_devicegraphs()
     {
 	y2mil("probe begin");
 
@@ -195,17 +322,48 @@ namespace storage
 	y2mil("probed devicegraph end");
 
 	copy_devicegraph("probed", "staging");
+
+	flush_log();
     }
 
 
     void
     Storage::Impl::probe_helper(Devicegraph* probed)
     {
-	SystemInfo system_info;
+	const string& probe_cache_filename = environment.get_impl().get_probe_cache_filename();
+
+	std::unique_ptr<ProbeCache> probe_cache;
+
+	if (!probe_cache_filename.empty() && probes_real_system())
+	{
+	    probe_cache.reset(new ProbeCache(probe_cache_filename));
+
+	    // With the SystemInfo of the last probe reprobe() was called.
 
-	arch = system_info.getArch();
+	    if (!system_info && probe_cache->load(probed, arch))
+		return;
+	}
 
-	Prober prober(probed, system_info);
+	if (!system_info)
+	    system_info.reset(new SystemInfo());
+
+	try
+	{
+	    arch = system_info->getArch();
+
+	    Prober prober(probed, *system_info);
+	}
+	catch (...)
+	{
+	    system_info.reset();
+	    throw;
+	}
+
+	if (probe_cache)
+	    probe_cache->save(probed, arch);
+
+	if (!probes_real_system())
+	    system_info.reset();
     }
 
 
@@ -405,7 +563,48 @@ namespace storage
     {
 	ST_CHECK_PTR(actiongraph.get());
 
-	actiongraph->get_impl().commit(commit_options, commit_callbacks);
+	// The probe cache must not be used after the commit. Invalidated
+	// before and after committing since another process might save the
+	// cache meanwhile.
+
+	const string& probe_cache_filename = environment.get_impl().get_probe_cache_filename();
+
+	if (!probe_cache_filename.empty())
+	    ProbeCache::invalidate(probe_cache_filename);
+
+	try
+	{
+	    // With several threads an action needing a filesystem unmounted
+	    // could run while another thread still uses a cached temporary
+	    // mount of it. So the cache is only used with one thread.
+
+	    unique_ptr<TmpMountCache::Enabler> tmp_mount_cache_enabler;
+	    if (commit_options.num_threads <= 1)
+		tmp_mount_cache_enabler.reset(new TmpMountCache::Enabler(tmp_mount_cache));
+
+	    actiongraph->get_impl().commit(commit_options, commit_callbacks);
+	}
+	catch (...)
+	{
+	    system_info.reset();
+
+	    if (!probe_cache_filename.empty())
+		ProbeCache::invalidate(probe_cache_filename);
+
+	    flush_log();
+	    throw;
+	}
+
+	if (!probe_cache_filename.empty())
+	    ProbeCache::invalidate(probe_cache_filename);
+
+	if (system_info)
+	{
+	    set<string> tmp = actiongraph->get_impl().get_touched_names();
+	    touched_names.insert(tmp.begin(), tmp.end());
+	}
+
+	flush_log();
 
 	// TODO somehow update probed
     }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -26,6 +26,8 @@
 
 
 #include <map>
+#include <set>
+#include <memory>
 
 #include "storage/Utils/FileUtils.h"
 #include "storage/Storage.h"
@@ -38,6 +40,89 @@ namespace storage
 {
     using std::string;
     using std::map;
+    using std::set;
+
+
+    class SystemInfo;
+
+
+    /**
+     * Cache for the temporary mounts done by EnsureMounted so that e.g.
+     * creating several btrfs subvolumes mounts the filesystem only
+     * once. The cache is only enabled during commit with one thread, see
+     * Storage::Impl::commit(). During probing it
+     * must not be used since /proc/mounts would contain the temporary
+     * mounts when read. The entries are keyed by the sid of the
+     * mountable.
+     */
+    class TmpMountCache : private boost::noncopyable
+    {
+    public:
+
+	~TmpMountCache();
+
+	bool is_enabled() const { return enabled; }
+
+	/**
+	 * Enables the cache for the lifetime of the object. Afterwards
+	 * all cached temporary mounts are unmounted.
+	 */
+	class Enabler : private boost::noncopyable
+	{
+	public:
+
+	    Enabler(TmpMountCache& tmp_mount_cache);
+	    ~Enabler();
+
+	private:
+
+	    TmpMountCache& tmp_mount_cache;
+
+	};
+
+	/**
+	 * Returns the cached temporary mount of the mountable or nullptr.
+	 * A read-only mount is not returned if read_only is false.
+	 */
+	std::shared_ptr<TmpMount> find(sid_t sid, bool read_only) const;
+
+	/**
+	 * Adds a temporary mount. The filesystem_sid is the sid of the
+	 * filesystem the mountable belongs to and is used by
+	 * release_all_except().
+	 */
+	void insert(sid_t sid, sid_t filesystem_sid, bool read_only,
+		    std::shared_ptr<TmpMount> tmp_mount);
+
+	/**
+	 * Unmounts all temporary mounts not belonging to the filesystem,
+	 * e.g. before an action possibly needing the other filesystems
+	 * unmounted.
+	 */
+	void release_all_except(sid_t filesystem_sid);
+
+	/**
+	 * Unmounts the temporary mount of the mountable (unless still in
+	 * use elsewhere).
+	 */
+	void erase(sid_t sid);
+
+	void clear();
+
+    private:
+
+	struct Entry
+	{
+	    sid_t filesystem_sid;
+	    bool read_only;
+	    std::shared_ptr<TmpMount> tmp_mount;
+	};
+
+	map<sid_t, Entry> entries;
+
+	bool enabled = false;
+
+    };
 
 
     class Storage::Impl
@@ -89,15 +174,26 @@ namespace storage
 	DeactivateStatus deactivate() const;
 
 	void probe();
+	void reprobe();
 
 	void commit(const CommitOptions& commit_options, const CommitCallbacks* commit_callbacks);
 
 	const TmpDir& get_tmp_dir() const { return tmp_dir; }
 
+	TmpMountCache& get_tmp_mount_cache() const { return tmp_mount_cache; }
+
     private:
 
+	void probe_devicegraphs();
 	void probe_helper(Devicegraph* probed);
 
+	/**
+	 * Whether probing reads the real system, so without mockup. Only
+	 * then the SystemInfo of the last probe is kept for reprobe() and
+	 * the probe cache is used.
+	 */
+	bool probes_real_system() const;
+
 	const Storage& storage;
 
 	const Environment environment;
@@ -112,8 +208,22 @@ namespace storage
 
 	std::unique_ptr<const Actiongraph> actiongraph;
 
+	/**
+	 * The SystemInfo of the last probe and the names of the devices
+	 * touched by commits since then, used by reprobe(). For devices not
+	 * touched the cached per-device results (parted, dasdview, btrfs
+	 * subvolume list and get-default, mdadm detail, udevadm info and
+	 * lsattr) are reused, everything else is read again, see
+	 * SystemInfo::invalidate(). Reset if a commit fails.
+	 */
+	std::unique_ptr<SystemInfo> system_info;
+	set<string> touched_names;
+
 	TmpDir tmp_dir;
 
+	// must be destroyed before tmp_dir
+	mutable TmpMountCache tmp_mount_cache;
+
     };
 
 }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -50,6 +50,15 @@ namespace storage
     {
 	getChildValue(node, "arch", arch);
 
+	if (!getChildValue(node, "ppc-mac", ppc_mac))
+	    ppc_mac = false;
+
+	if (!getChildValue(node, "ppc-pegasos", ppc_pegasos))
+	    ppc_pegasos = false;
+
+	if (!getChildValue(node, "ppc-power-nv", ppc_power_nv))
+	    ppc_power_nv = false;
+
 	if (!getChildValue(node, "efiboot", efiboot))
 	    efiboot = false;
 
@@ -62,6 +71,10 @@ namespace storage
     {
 	setChildValue(node, "arch", arch);
 
+	setChildValueIf(node, "ppc-mac", ppc_mac, ppc_mac);
+	setChildValueIf(node, "ppc-pegasos", ppc_pegasos, ppc_pegasos);
+	setChildValueIf(node, "ppc-power-nv", ppc_power_nv, ppc_power_nv);
+
 	setChildValueIf(node, "efiboot", efiboot, efiboot);
 
 	setChildValue(node, "page-size", page_size);
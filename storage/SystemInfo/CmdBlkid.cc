@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2014] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -21,15 +21,28 @@
  */
 
 
+#include "config.h"
+
+#include <sys/stat.h>
+#include <sys/sysmacros.h>
+#include <string.h>
 #include <algorithm>
+#include <fstream>
 #include <boost/algorithm/string.hpp>
 
+#ifdef HAVE_LIBBLKID
+#include <blkid.h>
+#endif
+
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/ThreadPool.h"
 #include "storage/SystemInfo/SystemInfo.h"
 #include "storage/SystemInfo/CmdBlkid.h"
 #include "storage/Filesystems/FilesystemImpl.h"
+#include "storage/Prober.h"
 
 
 namespace storage
@@ -37,9 +50,139 @@ namespace storage
     using namespace std;
 
 
+#ifdef HAVE_LIBBLKID
+
+    namespace
+    {
+
+	/*
+	 * Returns the block devices like blkid does: all devices listed
+	 * in /proc/partitions, device mapper devices with their name in
+	 * /dev/mapper.
+	 */
+	vector<pair<string, dev_t>>
+	list_block_devices()
+	{
+	    vector<pair<string, dev_t>> ret;
+
+	    ifstream s("/proc/partitions");
+	    string line;
+	    while (getline(s, line))
+	    {
+		unsigned int major_num, minor_num;
+		unsigned long long blocks;
+		string short_name;
+
+		istringstream data(line);
+		classic(data);
+		data >> major_num >> minor_num >> blocks >> short_name;
+		if (data.fail())
+		    continue;
+
+		string name = DEVDIR "/" + boost::replace_all_copy(short_name, "!", "/");
+
+		if (boost::starts_with(short_name, "dm-"))
+		{
+		    ifstream s2(SYSFSDIR "/block/" + short_name + "/dm/name");
+		    string dm_name;
+		    if (getline(s2, dm_name) && !dm_name.empty())
+			name = DEVMAPPERDIR "/" + dm_name;
+		}
+
+		ret.emplace_back(name, makedev(major_num, minor_num));
+	    }
+
+	    return ret;
+	}
+
+
+	/*
+	 * Low-level probing of the superblocks like 'blkid -c /dev/null'
+	 * does. Returns false if nothing was detected.
+	 */
+	bool
+	probe_device(const string& name, map<string, string>& tags)
+	{
+	    blkid_probe pr = blkid_new_probe_from_filename(name.c_str());
+	    if (!pr)
+	    {
+		y2deb("blkid_new_probe_from_filename failed for " << name << ", " << strerror(errno));
+		return false;
+	    }
+
+	    blkid_probe_enable_superblocks(pr, 1);
+	    blkid_probe_set_superblocks_flags(pr, BLKID_SUBLKS_DEFAULT);
+	    blkid_probe_enable_partitions(pr, 0);
+
+	    bool ret = blkid_do_safeprobe(pr) == 0;
+	    if (ret)
+	    {
+		int num = blkid_probe_numof_values(pr);
+		for (int i = 0; i < num; ++i)
+		{
+		    const char* tag;
+		    const char* value;
+		    if (blkid_probe_get_value(pr, i, &tag, &value, nullptr) == 0)
+			tags[tag] = value;
+		}
+	    }
+
+	    blkid_free_probe(pr);
+
+	    return ret && !tags.empty();
+	}
+
+
+	/*
+	 * Formats the tags like the blkid program.
+	 */
+	string
+	format_line(const string& name, const map<string, string>& tags)
+	{
+	    string line = name + ":";
+
+	    for (const map<string, string>::value_type& tag : tags)
+	    {
+		string value;
+		for (char c : tag.second)
+		{
+		    if (c == '"' || c == '\\')
+			value += '\\';
+		    value += c;
+		}
+
+		line += " " + tag.first + "=\"" + value + "\"";
+	    }
+
+	    return line;
+	}
+
+    }
+
+#endif
+
+
+    /*
+     * With libblkid the devices are probed directly unless in mockup
+     * playback mode or with remote callbacks. In those cases and when
+     * recording the output of the blkid command is used as mockup key so
+     * that existing mockup files still work.
+     */
+
+
     Blkid::Blkid()
     {
-	SystemCmd cmd(BLKIDBIN " -c '/dev/null'");
+	const string cmd_line = BLKIDBIN " -c '/dev/null'";
+
+#ifdef HAVE_LIBBLKID
+	if (Mockup::get_mode() != Mockup::Mode::PLAYBACK && !get_remote_callbacks())
+	{
+	    probe(list_block_devices(), cmd_line);
+	    return;
+	}
+#endif
+
+	SystemCmd cmd(cmd_line);
 	if (cmd.retcode() == 0)
 	    parse(cmd.stdout());
     }
@@ -47,16 +190,107 @@ namespace storage
 
     Blkid::Blkid(const string& device)
     {
-	SystemCmd cmd(BLKIDBIN " -c '/dev/null' " + quote(device));
+	const string cmd_line = BLKIDBIN " -c '/dev/null' " + quote(device);
+
+#ifdef HAVE_LIBBLKID
+	if (Mockup::get_mode() != Mockup::Mode::PLAYBACK && !get_remote_callbacks())
+	{
+	    struct stat buf;
+	    if (stat(device.c_str(), &buf) != 0)
+	    {
+		y2err("stat failed for " << device << ", " << strerror(errno));
+		return;
+	    }
+
+	    probe({ { device, buf.st_rdev } }, cmd_line);
+	    return;
+	}
+#endif
+
+	SystemCmd cmd(cmd_line);
 	if (cmd.retcode() == 0)
 	    parse(cmd.stdout());
     }
 
 
+    bool
+    Blkid::make_entry(const map<string, string>& m, Entry& entry)
+    {
+	map<string, string>::const_iterator it1 = m.find("TYPE");
+	if (it1 != m.end())
+	{
+	    if (toValue(it1->second, entry.fs_type, false))
+	    {
+		entry.is_fs = true;
+	    }
+	    else if (it1->second == "jbd" || it1->second == "xfs_external_log")
+	    {
+		entry.is_journal = true;
+	    }
+	    else if (boost::ends_with(it1->second, "_raid_member"))
+	    {
+		entry.is_md = true;
+	    }
+	    else if (it1->second == "LVM2_member")
+	    {
+		entry.is_lvm = true;
+	    }
+	    else if (it1->second == "crypto_LUKS")
+	    {
+		entry.is_luks = true;
+	    }
+	    else if (it1->second == "bcache")
+	    {
+		entry.is_bcache = true;
+	    }
+	}
+
+	if (entry.is_fs)
+	{
+	    it1 = m.find("UUID");
+	    if (it1 != m.end())
+		entry.fs_uuid = it1->second;
+
+	    it1 = m.find("LABEL");
+	    if (it1 != m.end())
+		entry.fs_label = it1->second;
+
+	    it1 = m.find("EXT_JOURNAL");
+	    if (it1 != m.end())
+		entry.fs_journal_uuid = it1->second;
+	}
+
+	if (entry.is_journal)
+	{
+	    it1 = m.find("LOGUUID");
+	    if (it1 != m.end())
+		entry.journal_uuid = it1->second;
+	}
+
+	if (entry.is_luks)
+	{
+	    it1 = m.find("UUID");
+	    if (it1 != m.end())
+		entry.luks_uuid = it1->second;
+	}
+
+	if (entry.is_bcache)
+	{
+	    it1 = m.find("UUID");
+	    if (it1 != m.end())
+		entry.bcache_uuid = it1->second;
+	}
+
+	return entry.is_fs || entry.is_journal || entry.is_md || entry.is_lvm || entry.is_luks ||
+	    entry.is_bcache;
+    }
+
+
     void
     Blkid::parse(const vector<string>& lines)
     {
 	data.clear();
+	names_by_majorminor.clear();
 
 	for (vector<string>::const_iterator it = lines.begin(); it != lines.end(); ++it)
 	{
@@ -67,83 +301,83 @@ namespace storage
 	    string device = string(*it, 0, pos);
 	    list<string> l = splitString(string(*it, pos + 1), " \t\n", true, true, "\"");
 
+	    const map<string, string> m = makeMap(l, "=", "\"");
+
 	    Entry entry;
+	    if (make_entry(m, entry))
+		data[device] = entry;
+	}
 
-	    const map<string, string> m = makeMap(l, "=", "\"");
+	y2mil(*this);
+    }
 
-	    map<string, string>::const_iterator it1 = m.find("TYPE");
-	    if (it1 != m.end())
-	    {
-		if (toValue(it1->second, entry.fs_type, false))
-		{
-		    entry.is_fs = true;
-		}
-		else if (it1->second == "jbd" || it1->second == "xfs_external_log")
-		{
-		    entry.is_journal = true;
-		}
-		else if (boost::ends_with(it1->second, "_raid_member"))
-		{
-		    entry.is_md = true;
-		}
-		else if (it1->second == "LVM2_member")
-		{
-		    entry.is_lvm = true;
-		}
-		else if (it1->second == "crypto_LUKS")
-		{
-		    entry.is_luks = true;
-		}
-		else if (it1->second == "bcache")
-		{
-		    entry.is_bcache = true;
-		}
-	    }
 
-	    if (entry.is_fs)
-	    {
-		it1 = m.find("UUID");
-		if (it1 != m.end())
-		    entry.fs_uuid = it1->second;
+#ifdef HAVE_LIBBLKID
 
-		it1 = m.find("LABEL");
-		if (it1 != m.end())
-		    entry.fs_label = it1->second;
+    void
+    Blkid::probe(const vector<pair<string, dev_t>>& devices, const string& cmd_line)
+    {
+	data.clear();
+	names_by_majorminor.clear();
 
-		it1 = m.find("EXT_JOURNAL");
-		if (it1 != m.end())
-		    entry.fs_journal_uuid = it1->second;
-	    }
+	vector<map<string, string>> tags(devices.size());
+	vector<char> found(devices.size(), false);
 
-	    if (entry.is_journal)
-	    {
-		it1 = m.find("LOGUUID");
-		if (it1 != m.end())
-		    entry.journal_uuid = it1->second;
-	    }
+	// Like prefetching the devices are only probed in parallel if
+	// requested since the logger must be thread-safe for that.
+
+	const unsigned int num_threads = Prober::probe_threads();
 
-	    if (entry.is_luks)
+	if (num_threads > 1)
+	{
+	    // Every task only writes its own element of tags and found.
+
+	    vector<ThreadPool::task_t> tasks;
+	    for (size_t i = 0; i < devices.size(); ++i)
 	    {
-		it1 = m.find("UUID");
-		if (it1 != m.end())
-		    entry.luks_uuid = it1->second;
+		tasks.push_back([&devices, &tags, &found, i]() {
+		    found[i] = probe_device(devices[i].first, tags[i]);
+		});
 	    }
 
-	    if (entry.is_bcache)
+	    ThreadPool::run(tasks, num_threads);
+	}
+	else
+	{
+	    for (size_t i = 0; i < devices.size(); ++i)
+		found[i] = probe_device(devices[i].first, tags[i]);
+	}
+
+	vector<string> lines;
+
+	for (size_t i = 0; i < devices.size(); ++i)
+	{
+	    if (!found[i])
+		continue;
+
+	    if (Mockup::get_mode() == Mockup::Mode::RECORD)
+		lines.push_back(format_line(devices[i].first, tags[i]));
+
+	    Entry entry;
+	    if (make_entry(tags[i], entry))
 	    {
-		it1 = m.find("UUID");
-		if (it1 != m.end())
-		    entry.bcache_uuid = it1->second;
+		data[devices[i].first] = entry;
+		names_by_majorminor[devices[i].second] = devices[i].first;
 	    }
+	}
 
-	    if (entry.is_fs || entry.is_journal || entry.is_md || entry.is_lvm || entry.is_luks ||
-		entry.is_bcache)
-		data[device] = entry;
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	{
+	    // Like the blkid program use exit code 2 if nothing was found.
+
+	    Mockup::set_command(cmd_line, Mockup::Command(lines, {}, lines.empty() ? 2 : 0));
 	}
 
 	y2mil(*this);
     }
 
+#endif
+
 
     Blkid::const_iterator
     Blkid::find_by_name(const string& device, SystemInfo& system_info) const
@@ -153,6 +387,35 @@ namespace storage
 	    return it;
 
 	dev_t majorminor = system_info.getCmdUdevadmInfo(device).get_majorminor();
+
+	// If the device is not found by its major and minor number the
+	// udev aliases are checked below.
+
+	if (!names_by_majorminor.empty())
+	{
+	    map<dev_t, string>::const_iterator it2 = names_by_majorminor.find(majorminor);
+	    if (it2 != names_by_majorminor.end())
+		return data.find(it2->second);
+	}
+
+	const vector<string>* names = system_info.find_names_by_majorminor(majorminor);
+	if (names)
+	{
+	    // Same result as the comparison below: the first entry in the
+	    // map with a matching name.
+
+	    const_iterator ret = end();
+
+	    for (const string& name : *names)
+	    {
+		const_iterator tmp = data.find(name);
+		if (tmp != end() && (ret == end() || tmp->first < ret->first))
+		    ret = tmp;
+	    }
+
+	    return ret;
+	}
+
 	return find_if(begin(), end(), [&system_info, &majorminor](const value_type& tmp) {
 	    return system_info.getCmdUdevadmInfo(tmp.first).get_majorminor() == majorminor;
 	});
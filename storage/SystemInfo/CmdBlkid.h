@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2014] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -25,6 +25,7 @@
 #define STORAGE_CMD_BLKID_H
 
 
+#include <sys/types.h>
 #include <string>
 #include <map>
 #include <vector>
@@ -37,11 +38,17 @@ namespace storage
     using std::string;
     using std::map;
     using std::vector;
+    using std::pair;
 
 
     class SystemInfo;
 
 
+    /**
+     * Information about filesystems and other signatures on block
+     * devices. If available the devices are probed in parallel with
+     * libblkid, otherwise the blkid program is run.
+     */
     class Blkid
     {
     public:
@@ -101,10 +108,29 @@ namespace storage
 
     private:
 
+	/**
+	 * Evaluates the tags, e.g. TYPE and UUID, of a device. Returns
+	 * false if the device is of no interest.
+	 */
+	static bool make_entry(const map<string, string>& tags, Entry& entry);
+
 	void parse(const vector<string>& lines);
 
+	/**
+	 * Probes the devices with libblkid. In mockup record mode the
+	 * equivalent output of the blkid command is recorded for
+	 * cmd_line.
+	 */
+	void probe(const vector<pair<string, dev_t>>& devices, const string& cmd_line);
+
 	map<string, Entry> data;
 
+	/**
+	 * Names of the entries by major and minor number. Only available if
+	 * the devices were probed with libblkid.
+	 */
+	map<dev_t, string> names_by_majorminor;
+
     };
 
 }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -20,7 +20,12 @@
  */
 
 
+#include <sys/statvfs.h>
+#include <string.h>
+
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/AppUtil.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
@@ -33,12 +38,51 @@ namespace storage
     using namespace std;
 
 
+    /*
+     * The filesystem is queried directly with statvfs() unless in mockup
+     * playback mode or with remote callbacks. In those cases and when
+     * recording the output of the df command used previously is used as
+     * mockup key so that existing mockup files still work.
+     */
+
+
     CmdDf::CmdDf(const string& path)
 	: path(path), size(0), used(0)
     {
-	SystemCmd cmd(DFBIN " --block-size=1 --output=size,used,avail,fstype " + quote(path));
-	if (cmd.retcode() == 0)
-	    parse(cmd.stdout());
+	const string cmd_line = DFBIN " --block-size=1 --output=size,used,avail,fstype " + quote(path);
+
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	{
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() == 0)
+		parse(cmd.stdout());
+
+	    return;
+	}
+
+	struct statvfs buf;
+	if (statvfs(path.c_str(), &buf) != 0)
+	{
+	    y2err("statvfs failed for " << path << ", " << strerror(errno));
+	    return;
+	}
+
+	// Same calculation as df.
+
+	size = (unsigned long long)(buf.f_blocks) * buf.f_frsize;
+	used = (unsigned long long)(buf.f_blocks - buf.f_bfree) * buf.f_frsize;
+
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	{
+	    // The filesystem type is not known here but not needed by
+	    // parse().
+
+	    unsigned long long avail = (unsigned long long)(buf.f_bavail) * buf.f_frsize;
+
+	    Mockup::set_command(cmd_line, Mockup::Command({
+		"1B-blocks Used Avail Type", sformat("%llu %llu %llu -", size, used, avail)
+	    }));
+	}
     }
 
 
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) [2015-2017] SUSE LLC
+ * Copyright (c) [2015-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -20,15 +20,21 @@
  */
 
 
+#include <fcntl.h>
+#include <unistd.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <linux/fs.h>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/AppUtil.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/CmdLsattr.h"
 #include "storage/Utils/Enum.h"
-#include "storage/Utils/Exception.h"
+#include "storage/Utils/ExceptionImpl.h"
 
 
 namespace storage
@@ -36,18 +42,66 @@ namespace storage
     using namespace std;
 
 
+    /*
+     * The flags are queried directly with the FS_IOC_GETFLAGS ioctl unless
+     * in mockup playback mode or with remote callbacks. In those cases and
+     * when recording the output of the lsattr command used previously is
+     * used as mockup so that existing mockup files still work.
+     */
+
+
     CmdLsattr::CmdLsattr(const key_t& key, const string& mountpoint, const string& path)
 	: mountpoint(mountpoint), path(path)
     {
-	SystemCmd::Options cmd_options(LSATTRBIN " -d " + quote(mountpoint + "/" + path));
-	cmd_options.mockup_key = LSATTRBIN " -d (device:" + get<0>(key) + " path:" + get<1>(key) + ")";
-	cmd_options.throw_behaviour = SystemCmd::DoThrow;
+	const string mockup_key = LSATTRBIN " -d (device:" + get<0>(key) + " path:" + get<1>(key) + ")";
+
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	{
+	    SystemCmd::Options cmd_options(LSATTRBIN " -d " + quote(mountpoint + "/" + path));
+	    cmd_options.mockup_key = mockup_key;
+	    cmd_options.throw_behaviour = SystemCmd::DoThrow;
+
+	    SystemCmd cmd(cmd_options);
+	    if (cmd.retcode() != 0)
+		ST_THROW(SystemCmdException(&cmd, "lsattr failed, retcode:" + to_string(cmd.retcode())));
+
+	    parse(cmd.stdout());
+
+	    return;
+	}
+
+	const string full_path = mountpoint + "/" + path;
+
+	// Same open flags as lsattr.
 
-	SystemCmd cmd(cmd_options);
-	if (cmd.retcode() != 0)
-	    ST_THROW(SystemCmdException(&cmd, "lsattr failed, retcode:" + to_string(cmd.retcode())));
+	int fd = open(full_path.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+	if (fd < 0)
+	    ST_THROW(Exception(sformat("open failed for %s, %s", full_path.c_str(), strerror(errno))));
 
-	parse(cmd.stdout());
+	int flags = 0;
+	int r = ioctl(fd, FS_IOC_GETFLAGS, &flags);
+	int errnum = errno;
+
+	close(fd);
+
+	if (r != 0)
+	    ST_THROW(Exception(sformat("FS_IOC_GETFLAGS failed for %s, %s", full_path.c_str(),
+				       strerror(errnum))));
+
+	nocow = flags & FS_NOCOW_FL;
+
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	{
+	    // Only the NOCOW flag is recorded, at the position lsattr uses.
+
+	    string attrs(19, '-');
+	    if (nocow)
+		attrs[16] = 'C';
+
+	    Mockup::set_command(mockup_key, Mockup::Command({ attrs + " " + full_path }));
+	}
+
+	y2mil(*this);
     }
 
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2014] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -42,43 +42,50 @@ namespace storage
     using namespace std;
 
 
-    void
-    CmdLvm::parse(const vector<string>& lines, const char* tag)
+    bool
+    CmdLvm::execute(const string& command, JsonFile& json_file)
     {
-	JsonFile json_file(lines);
+	SystemCmd::Options options(command);
+	options.stdout_processor = &json_file;
 
-	vector<json_object*> tmp1;
-	if (get_child_nodes(json_file.get_root(), "report", tmp1))
-	{
-	    for (json_object* tmp2 : tmp1)
-	    {
-		vector<json_object*> tmp3;
-		if (get_child_nodes(tmp2, tag, tmp3))
-		{
-		    for (json_object* tmp4 : tmp3)
-			parse(tmp4);
-		}
-	    }
-	}
+	SystemCmd cmd(options);
+
+	return cmd.retcode() == 0 && json_file.get_root();
+    }
+
+
+    void
+    CmdLvm::parse(const JsonFile& json_file, const char* tag)
+    {
+	for_each_child_node(json_file.get_root(), "report", [this, tag](json_object* report) {
+	    for_each_child_node(report, tag, [this](json_object* object) { parse(object); });
+	});
     }
 
 
     CmdPvs::CmdPvs()
     {
-	SystemCmd cmd(PVSBIN " " COMMON_LVM_OPTIONS " --options pv_name,pv_uuid,vg_name,vg_uuid,"
-		      "pv_attr");
-	if (cmd.retcode() == 0 && !cmd.stdout().empty())
-	    parse(cmd.stdout());
+	JsonFile json_file;
+	if (execute(PVSBIN " " COMMON_LVM_OPTIONS " --options pv_name,pv_uuid,vg_name,vg_uuid,"
+		    "pv_attr", json_file))
+	    parse(json_file);
     }
 
 
     void
-    CmdPvs::parse(const vector<string>& lines)
+    CmdPvs::parse(const JsonFile& json_file)
     {
 	pvs.clear();
 
-	CmdLvm::parse(lines, "pv");
+	CmdLvm::parse(json_file, "pv");
+
+	sort_and_log();
+    }
+
 
+    void
+    CmdPvs::sort_and_log()
+    {
 	sort(pvs.begin(), pvs.end(), [](const Pv& lhs, const Pv& rhs) { return lhs.pv_name < rhs.pv_name; });
 
 	y2mil(*this);
@@ -140,22 +147,28 @@ namespace storage
 
     CmdLvs::CmdLvs()
     {
-	SystemCmd cmd(LVSBIN " " COMMON_LVM_OPTIONS " --all --options lv_name,lv_uuid,vg_name,"
-		      "vg_uuid,lv_role,lv_attr,lv_size,stripes,stripe_size,chunk_size,pool_lv,"
-		      "pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid");
-
-	if (cmd.retcode() == 0 && !cmd.stdout().empty())
-	    parse(cmd.stdout());
+	JsonFile json_file;
+	if (execute(LVSBIN " " COMMON_LVM_OPTIONS " --all --options lv_name,lv_uuid,vg_name,"
+		    "vg_uuid,lv_role,lv_attr,lv_size,stripes,stripe_size,chunk_size,pool_lv,"
+		    "pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid", json_file))
+	    parse(json_file);
     }
 
 
     void
-    CmdLvs::parse(const vector<string>& lines)
+    CmdLvs::parse(const JsonFile& json_file)
     {
 	lvs.clear();
 
-	CmdLvm::parse(lines, "lv");
+	CmdLvm::parse(json_file, "lv");
+
+	sort_and_log();
+    }
+
 
+    void
+    CmdLvs::sort_and_log()
+    {
 	sort(lvs.begin(), lvs.end(), [](const Lv& lhs, const Lv& rhs) { return lhs.lv_name < rhs.lv_name; });
 
 	y2mil(*this);
@@ -164,9 +177,34 @@ namespace storage
 
     void
     CmdLvs::parse(json_object* object)
+    {
+	Lv lv = parse_lv(object);
+	Segment segment = parse_segment(object);
+
+	// The stripes and chunksize options makes lvs print every segment of
+	// a LV. Depending on whether the LV is already in lvs, either add the
+	// complete LV or only the segment to the already existing LV.
+
+	vector<Lv>::iterator it = find_if(lvs.begin(), lvs.end(), [lv](const Lv& tmp) {
+	    return lv.lv_uuid == tmp.lv_uuid;
+	});
+
+	if (it == lvs.end())
+	{
+	    lv.segments.push_back(segment);
+	    lvs.push_back(lv);
+	}
+	else
+	{
+	    it->segments.push_back(segment);
+	}
+    }
+
+
+    CmdLvs::Lv
+    CmdLvs::parse_lv(json_object* object)
     {
 	Lv lv;
-	Segment segment;
 
 	get_child_value(object, "lv_name", lv.lv_name);
 	get_child_value(object, "lv_uuid", lv.lv_uuid);
@@ -198,28 +236,21 @@ namespace storage
 	get_child_value(object, "metadata_lv", lv.metadata_name);
 	get_child_value(object, "metadata_lv_uuid", lv.metadata_uuid);
 
+	return lv;
+    }
+
+
+    CmdLvs::Segment
+    CmdLvs::parse_segment(json_object* object)
+    {
+	Segment segment;
+
 	get_child_value(object, "stripes", segment.stripes);
 	get_child_value(object, "stripe_size", segment.stripe_size);
 
 	get_child_value(object, "chunk_size", segment.chunk_size);
 
-	// The stripes and chunksize options makes lvs print every segment of
-	// a LV. Depending on whether the LV is already in lvs, either add the
-	// complete LV or only the segment to the already existing LV.
-
-	vector<Lv>::iterator it = find_if(lvs.begin(), lvs.end(), [lv](const Lv& tmp) {
-	    return lv.lv_uuid == tmp.lv_uuid;
-	});
-
-	if (it == lvs.end())
-	{
-	    lv.segments.push_back(segment);
-	    lvs.push_back(lv);
-	}
-	else
-	{
-	    it->segments.push_back(segment);
-	}
+	return segment;
     }
 
 
@@ -302,20 +333,27 @@ namespace storage
 
     CmdVgs::CmdVgs()
     {
-	SystemCmd cmd(VGSBIN " " COMMON_LVM_OPTIONS " --options vg_name,vg_uuid,vg_attr,"
-		      "vg_extent_size,vg_extent_count,vg_free_count");
-	if (cmd.retcode() == 0 && !cmd.stdout().empty())
-	    parse(cmd.stdout());
+	JsonFile json_file;
+	if (execute(VGSBIN " " COMMON_LVM_OPTIONS " --options vg_name,vg_uuid,vg_attr,"
+		    "vg_extent_size,vg_extent_count,vg_free_count", json_file))
+	    parse(json_file);
     }
 
 
     void
-    CmdVgs::parse(const vector<string>& lines)
+    CmdVgs::parse(const JsonFile& json_file)
     {
 	vgs.clear();
 
-	CmdLvm::parse(lines, "vg");
+	CmdLvm::parse(json_file, "vg");
+
+	sort_and_log();
+    }
+
 
+    void
+    CmdVgs::sort_and_log()
+    {
 	sort(vgs.begin(), vgs.end(), [](const Vg& lhs, const Vg& rhs) { return lhs.vg_name < rhs.vg_name; });
 
 	y2mil(*this);
@@ -376,4 +414,76 @@ namespace storage
 	return s;
     }
 
+
+
+    CmdLvmFullreport::CmdLvmFullreport()
+	: cmd_pvs(no_run_t()), cmd_vgs(no_run_t()), cmd_lvs(no_run_t())
+    {
+	// The options of the sub-reports are the same as used for pvs, vgs
+	// and lvs. The segments of the LVs are reported separately.
+
+	JsonFile json_file;
+
+	SystemCmd::Options options(LVMBIN " fullreport " COMMON_LVM_OPTIONS " --all "
+				   "--configreport pv --options pv_name,pv_uuid,vg_name,vg_uuid,pv_attr "
+				   "--configreport vg --options vg_name,vg_uuid,vg_attr,vg_extent_size,"
+				   "vg_extent_count,vg_free_count "
+				   "--configreport lv --options lv_name,lv_uuid,vg_name,vg_uuid,lv_role,lv_attr,"
+				   "lv_size,pool_lv,pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid "
+				   "--configreport seg --options lv_uuid,stripes,stripe_size,chunk_size "
+				   "--configreport pvseg --options pv_uuid");
+	options.stdout_processor = &json_file;
+
+	SystemCmd cmd(options);
+	if (cmd.retcode() != 0)
+	    ST_THROW(SystemCmdException(&cmd, "'lvm fullreport' failed, ret: " +
+					to_string(cmd.retcode())));
+
+	parse(json_file);
+    }
+
+
+    void
+    CmdLvmFullreport::parse(const JsonFile& json_file)
+    {
+	// The report has one entry per VG, including one for the PVs not in
+	// any VG.
+
+	for_each_child_node(json_file.get_root(), "report", [this](json_object* report) {
+	    parse(report);
+	});
+
+	cmd_pvs.sort_and_log();
+	cmd_vgs.sort_and_log();
+	cmd_lvs.sort_and_log();
+    }
+
+
+    void
+    CmdLvmFullreport::parse(json_object* object)
+    {
+	for_each_child_node(object, "pv", [this](json_object* pv) { cmd_pvs.parse(pv); });
+
+	for_each_child_node(object, "vg", [this](json_object* vg) { cmd_vgs.parse(vg); });
+
+	for_each_child_node(object, "lv", [this](json_object* lv) {
+	    cmd_lvs.lvs.push_back(CmdLvs::parse_lv(lv));
+	});
+
+	for_each_child_node(object, "seg", [this](json_object* seg) {
+	    string lv_uuid;
+	    get_child_value(seg, "lv_uuid", lv_uuid);
+
+	    vector<CmdLvs::Lv>::iterator it = find_if(cmd_lvs.lvs.begin(), cmd_lvs.lvs.end(),
+						      [&lv_uuid](const CmdLvs::Lv& lv) {
+		return lv.lv_uuid == lv_uuid;
+	    });
+
+	    if (it == cmd_lvs.lvs.end())
+		ST_THROW(Exception("lv of segment not found by lv-uuid"));
+
+	    it->segments.push_back(CmdLvs::parse_segment(seg));
+	});
+    }
+
 }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2014] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -38,13 +38,26 @@ namespace storage
     using std::vector;
 
 
+    class CmdLvmFullreport;
+
+
     class CmdLvm
     {
     protected:
 
 	virtual ~CmdLvm() {}
 
-	void parse(const vector<string>& lines, const char* tag);
+	// Tag for the constructors used by CmdLvmFullreport, which do not run
+	// any command.
+	struct no_run_t {};
+
+	/**
+	 * Runs the command and parses its output while reading it. Returns
+	 * false if the command failed or had no output.
+	 */
+	static bool execute(const string& command, JsonFile& json_file);
+
+	void parse(const JsonFile& json_file, const char* tag);
 
 	virtual void parse(json_object* object) = 0;
 
@@ -76,9 +89,15 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
+	friend class CmdLvmFullreport;
+
+	CmdPvs(no_run_t) {}
+
+	void parse(const JsonFile& json_file);
 	void parse(json_object* object) override;
 
+	void sort_and_log();
+
 	vector<Pv> pvs;
 
     };
@@ -134,9 +153,18 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
+	friend class CmdLvmFullreport;
+
+	CmdLvs(no_run_t) {}
+
+	void parse(const JsonFile& json_file);
 	void parse(json_object* object) override;
 
+	static Lv parse_lv(json_object* object);
+	static Segment parse_segment(json_object* object);
+
+	void sort_and_log();
+
 	vector<Lv> lvs;
 
     };
@@ -168,13 +196,48 @@ namespace storage
 
     private:
 
-	void parse(const vector<string>& lines);
+	friend class CmdLvmFullreport;
+
+	CmdVgs(no_run_t) {}
+
+	void parse(const JsonFile& json_file);
 	void parse(json_object* object) override;
 
+	void sort_and_log();
+
 	vector<Vg> vgs;
 
     };
 
+
+    /**
+     * Runs 'lvm fullreport' once to get the information of pvs, vgs and lvs
+     * together. Each LVM tool rescans all PVs and takes the global LVM
+     * lock, so with many PVs this is much faster than running pvs, vgs and
+     * lvs. Older LVM versions do not support 'lvm fullreport', in that case
+     * the constructor throws.
+     */
+    class CmdLvmFullreport : protected CmdLvm
+    {
+    public:
+
+	CmdLvmFullreport();
+
+	const CmdPvs& get_cmd_pvs() const { return cmd_pvs; }
+	const CmdVgs& get_cmd_vgs() const { return cmd_vgs; }
+	const CmdLvs& get_cmd_lvs() const { return cmd_lvs; }
+
+    private:
+
+	void parse(const JsonFile& json_file);
+	void parse(json_object* object) override;
+
+	CmdPvs cmd_pvs;
+	CmdVgs cmd_vgs;
+	CmdLvs cmd_lvs;
+
+    };
+
 }
 
 #endif
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -24,6 +25,7 @@
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/ExceptionImpl.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/StorageTmpl.h"
@@ -35,8 +37,41 @@ namespace storage
     using namespace std;
 
 
+    CmdUdevadmInfo::CmdUdevadmInfo()
+	: file(), path(), name(), majorminor(0), by_path_links(), by_id_links()
+    {
+    }
+
+
     CmdUdevadmInfo::CmdUdevadmInfo(const string& file)
 	: file(file), path(), name(), majorminor(0), by_path_links(), by_id_links()
+    {
+	probe();
+    }
+
+
+    CmdUdevadmInfo::CmdUdevadmInfo(const string& file, const CmdUdevadmDb* cmd_udevadm_db)
+	: file(file), path(), name(), majorminor(0), by_path_links(), by_id_links()
+    {
+	const CmdUdevadmInfo* entry = cmd_udevadm_db ? cmd_udevadm_db->find_by_file(file) : nullptr;
+	if (!entry)
+	{
+	    probe();
+	    return;
+	}
+
+	path = entry->path;
+	name = entry->name;
+	majorminor = entry->majorminor;
+	by_path_links = entry->by_path_links;
+	by_id_links = entry->by_id_links;
+
+	y2mil(*this);
+    }
+
+
+    void
+    CmdUdevadmInfo::probe()
     {
 	// Without emptying the udev queue 'udevadm info' can display old data
 	// or even complain about unknown devices. Even during probing this
@@ -47,7 +82,11 @@ namespace storage
 
 	SystemCmd cmd(UDEVADMBIN " info " + quote(file));
 	if (cmd.retcode() == 0)
+	{
 	    parse(cmd.stdout());
+
+	    y2mil(*this);
+	}
     }
 
 
@@ -82,8 +121,6 @@ namespace storage
 
 	sort(by_path_links.begin(), by_path_links.end());
 	sort(by_id_links.begin(), by_id_links.end());
-
-	y2mil(*this);
     }
 
 
@@ -105,4 +142,122 @@ namespace storage
 	return s;
     }
 
+
+
+    CmdUdevadmDb::CmdUdevadmDb()
+    {
+	// See comment in CmdUdevadmInfo::probe().
+	SystemCmd(UDEVADMBIN_SETTLE);
+
+	SystemCmd cmd(UDEVADMBIN " info --export-db");
+	if (cmd.retcode() != 0)
+	    ST_THROW(SystemCmdException(&cmd, "'udevadm info --export-db' failed, ret: " +
+					to_string(cmd.retcode())));
+
+	parse(cmd.stdout());
+
+	y2mil(*this);
+    }
+
+
+    void
+    CmdUdevadmDb::parse(const vector<string>& stdout)
+    {
+	// The records of the devices are separated by empty lines.
+
+	vector<string> lines;
+
+	for (const string& line : stdout)
+	{
+	    if (line.empty())
+	    {
+		add_entry(lines);
+		lines.clear();
+	    }
+	    else
+	    {
+		lines.push_back(line);
+	    }
+	}
+
+	add_entry(lines);
+    }
+
+
+    void
+    CmdUdevadmDb::add_entry(const vector<string>& lines)
+    {
+	if (find(lines.begin(), lines.end(), "E: SUBSYSTEM=block") == lines.end())
+	    return;
+
+	CmdUdevadmInfo entry;
+	entry.parse(lines);
+
+	if (entry.name.empty())
+	    return;
+
+	entry.file = DEVDIR "/" + entry.name;
+
+	size_t idx = entries.size();
+	entries.push_back(entry);
+	names.push_back({ entry.file });
+
+	by_file[entry.file] = idx;
+	by_majorminor[entry.majorminor] = idx;
+
+	for (const string& line : lines)
+	{
+	    if (boost::starts_with(line, "S: "))
+	    {
+		names.back().push_back(DEVDIR "/" + line.substr(3));
+		by_file[names.back().back()] = idx;
+	    }
+
+	    if (boost::starts_with(line, "S: disk/by-uuid/"))
+		by_uuid[line.substr(16)] = idx;
+	}
+    }
+
+
+    const CmdUdevadmInfo*
+    CmdUdevadmDb::find_by_file(const string& file) const
+    {
+	std::unordered_map<string, size_t>::const_iterator it = by_file.find(file);
+	return it != by_file.end() ? &entries[it->second] : nullptr;
+    }
+
+
+    const CmdUdevadmInfo*
+    CmdUdevadmDb::find_by_majorminor(dev_t majorminor) const
+    {
+	std::unordered_map<dev_t, size_t>::const_iterator it = by_majorminor.find(majorminor);
+	return it != by_majorminor.end() ? &entries[it->second] : nullptr;
+    }
+
+
+    const vector<string>*
+    CmdUdevadmDb::find_names_by_majorminor(dev_t majorminor) const
+    {
+	std::unordered_map<dev_t, size_t>::const_iterator it = by_majorminor.find(majorminor);
+	return it != by_majorminor.end() ? &names[it->second] : nullptr;
+    }
+
+
+    const CmdUdevadmInfo*
+    CmdUdevadmDb::find_by_uuid(const string& uuid) const
+    {
+	std::unordered_map<string, size_t>::const_iterator it = by_uuid.find(uuid);
+	return it != by_uuid.end() ? &entries[it->second] : nullptr;
+    }
+
+
+    std::ostream&
+    operator<<(std::ostream& s, const CmdUdevadmDb& cmd_udevadm_db)
+    {
+	for (const CmdUdevadmInfo& entry : cmd_udevadm_db)
+	    s << entry;
+
+	return s;
+    }
+
 }
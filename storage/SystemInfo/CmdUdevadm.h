@@ -1,5 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -26,12 +27,19 @@
 
 #include <string>
 #include <vector>
+#include <map>
+#include <unordered_map>
+#include <sys/types.h>
 
 
 namespace storage
 {
     using std::string;
     using std::vector;
+    using std::map;
+
+
+    class CmdUdevadmDb;
 
 
     class CmdUdevadmInfo
@@ -39,8 +47,16 @@ namespace storage
 
     public:
 
+	typedef string key_t;
+
 	CmdUdevadmInfo(const string& file);
 
+	/**
+	 * Takes the information from cmd_udevadm_db if available and the
+	 * file is found there. Otherwise runs 'udevadm info'.
+	 */
+	CmdUdevadmInfo(const string& file, const CmdUdevadmDb* cmd_udevadm_db);
+
 	const string& get_path() const { return path; }
 	const string& get_name() const { return name; }
 
@@ -55,6 +71,12 @@ namespace storage
 
     private:
 
+	friend class CmdUdevadmDb;
+
+	CmdUdevadmInfo();
+
+	void probe();
+
 	void parse(const vector<string>& stdout);
 
 	string file;
@@ -69,6 +91,71 @@ namespace storage
 
     };
 
+
+    /**
+     * Runs 'udevadm info --export-db' once and keeps the information of all
+     * block devices in memory. Lookups are done via the device node, any
+     * of the symbolic links, the major and minor number or the filesystem
+     * UUID.
+     *
+     * This replaces one 'udevadm settle' and 'udevadm info' per device
+     * during probing.
+     */
+    class CmdUdevadmDb
+    {
+
+    public:
+
+	CmdUdevadmDb();
+
+	typedef vector<CmdUdevadmInfo>::const_iterator const_iterator;
+
+	const_iterator begin() const { return entries.begin(); }
+	const_iterator end() const { return entries.end(); }
+
+	size_t size() const { return entries.size(); }
+
+	/**
+	 * Find the entry by the device node or any symbolic link, e.g.
+	 * /dev/sda, /dev/mapper/system-root or /dev/disk/by-id/... Returns
+	 * nullptr if not found.
+	 */
+	const CmdUdevadmInfo* find_by_file(const string& file) const;
+
+	/**
+	 * Returns nullptr if not found.
+	 */
+	const CmdUdevadmInfo* find_by_majorminor(dev_t majorminor) const;
+
+	/**
+	 * Returns all names of the block device, i.e. the device node
+	 * followed by all symbolic links. Returns nullptr if not found.
+	 */
+	const vector<string>* find_names_by_majorminor(dev_t majorminor) const;
+
+	/**
+	 * Find the entry by the UUID of the filesystem, i.e. the
+	 * disk/by-uuid link. Returns nullptr if not found.
+	 */
+	const CmdUdevadmInfo* find_by_uuid(const string& uuid) const;
+
+	friend std::ostream& operator<<(std::ostream& s, const CmdUdevadmDb& cmd_udevadm_db);
+
+    private:
+
+	void parse(const vector<string>& stdout);
+
+	void add_entry(const vector<string>& lines);
+
+	vector<CmdUdevadmInfo> entries;
+	vector<vector<string>> names;
+
+	std::unordered_map<string, size_t> by_file;
+	std::unordered_map<dev_t, size_t> by_majorminor;
+	std::unordered_map<string, size_t> by_uuid;
+
+    };
+
 }
 
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) 2016 SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -21,6 +21,12 @@
  */
 
 
+#include <dirent.h>
+#include <fcntl.h>
+#include <string.h>
+#include <limits.h>
+#include <functional>
+#include <memory>
 #include <stdexcept>
 #include <boost/algorithm/string.hpp>
 
@@ -29,6 +35,8 @@
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/AppUtil.h"
+#include "storage/Utils/ExceptionImpl.h"
 #include "storage/SystemInfo/DevAndSys.h"
 
 
@@ -37,14 +45,68 @@ namespace storage
     using namespace std;
 
 
+    namespace
+    {
+
+	/*
+	 * Calls func for every entry of the directory except hidden ones
+	 * like ls does.
+	 */
+	void
+	read_directory(const string& path, std::function<void(int fd, const char* name)> func)
+	{
+	    // The directory is also closed if func throws.
+	    unique_ptr<DIR, int (*)(DIR*)> dir(opendir(path.c_str()), closedir);
+	    if (!dir)
+		ST_THROW(Exception(sformat("opendir failed for %s, %s", path.c_str(), strerror(errno))));
+
+	    int fd = dirfd(dir.get());
+
+	    struct dirent* entry;
+	    while ((entry = readdir(dir.get())) != nullptr)
+	    {
+		if (entry->d_name[0] == '.')
+		    continue;
+
+		func(fd, entry->d_name);
+	    }
+	}
+
+    }
+
+
+    /*
+     * Directories are read directly unless in mockup playback mode or with
+     * remote callbacks. In those cases and when recording the output of
+     * the 'ls' commands used previously is used as mockup key so that
+     * existing mockup files still work.
+     */
+
+
     Dir::Dir(const string& path)
 	: path(path)
     {
-	SystemCmd cmd(LSBIN " -1 --sort=none " + quote(path));
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("ls failure for " + path));
+	const string cmd_line = LSBIN " -1 --sort=none " + quote(path);
+
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	{
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("ls failure for " + path));
+
+	    parse(cmd.stdout());
+	}
+	else
+	{
+	    vector<string> lines;
+
+	    read_directory(path, [&lines](int fd, const char* name) { lines.push_back(name); });
 
-	parse(cmd.stdout());
+	    if (Mockup::get_mode() == Mockup::Mode::RECORD)
+		Mockup::set_command(cmd_line, Mockup::Command(lines));
+
+	    parse(lines);
+	}
 
 	y2mil(*this);
     }
@@ -171,13 +233,34 @@ namespace storage
     map<string, string>
     DevLinks::getDirLinks(const string& path) const
     {
-	// TODO use cmd(STATBIN " --format '%F %N' " + quote(path) + "/*")?
+	const string cmd_line = LSBIN " -1l --sort=none " + quote(path);
 
-	SystemCmd cmd(LSBIN " -1l --sort=none " + quote(path));
-	if (cmd.retcode() != 0)
-	    ST_THROW(Exception("ls failure for " + path));
+	if (Mockup::get_mode() == Mockup::Mode::PLAYBACK || get_remote_callbacks())
+	{
+	    SystemCmd cmd(cmd_line);
+	    if (cmd.retcode() != 0)
+		ST_THROW(Exception("ls failure for " + path));
+
+	    return parse(cmd.stdout());
+	}
+
+	// Only symbolic links are of interest. In the recorded lines the
+	// usual ls fields before the name are left out, parse() does not
+	// need them.
+
+	vector<string> lines;
+
+	read_directory(path, [&lines](int fd, const char* name) {
+	    char buf[PATH_MAX];
+	    ssize_t len = readlinkat(fd, name, buf, sizeof(buf));
+	    if (len > 0)
+		lines.push_back(string(name) + " -> " + string(buf, len));
+	});
+
+	if (Mockup::get_mode() == Mockup::Mode::RECORD)
+	    Mockup::set_command(cmd_line, Mockup::Command(lines));
 
-	return parse(cmd.stdout());
+	return parse(lines);
     }
 
 
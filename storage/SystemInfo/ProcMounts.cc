@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2014] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -21,6 +21,8 @@
  */
 
 
+#include <set>
+#include <regex>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/AsciiFile.h"
@@ -35,6 +37,25 @@ namespace storage
     using namespace std;
 
 
+    namespace
+    {
+
+	/*
+	 * Checks whether the mount point is a temporary mount done by
+	 * EnsureMounted, of this or another libstorage instance. Those are
+	 * no real mount points.
+	 */
+	bool
+	is_tmp_mount(const string& mount_point)
+	{
+	    static const regex tmp_mount_regex(".*/libstorage-[^/]{6}/tmp-mount-[^/]{6}", regex::extended);
+
+	    return regex_match(mount_point, tmp_mount_regex);
+	}
+
+    }
+
+
     ProcMounts::ProcMounts()
     {
 	AsciiFile mounts("/proc/mounts");
@@ -77,7 +98,8 @@ namespace storage
 
                 if ( entry->get_fs_type() == FsType::UNKNOWN ||
                      device == "rootfs" ||
-                     device == "/dev/root" )
+                     device == "/dev/root" ||
+                     is_tmp_mount(entry->get_mount_point()) )
                 {
                     // Get rid of all the useless stuff that clutters /proc/mounts
                     delete entry;
@@ -134,6 +156,24 @@ namespace storage
 
 	dev_t majorminor = system_info.getCmdUdevadmInfo(name).get_majorminor();
 
+	const vector<string>* names = system_info.find_names_by_majorminor(majorminor);
+	if (names)
+	{
+	    // Keeps the order of the loop below since data is sorted by name.
+
+	    set<string> all_names(names->begin(), names->end());
+	    all_names.insert(name);
+
+	    for (const string& tmp : all_names)
+	    {
+		pair<const_iterator, const_iterator> range = data.equal_range(tmp);
+		for (const_iterator it = range.first; it != range.second; ++it)
+		    ret.push_back(it->second);
+	    }
+
+	    return ret;
+	}
+
 	for (const value_type& value : data)
 	{
 	    if (value.first == name ||
@@ -1,5 +1,6 @@
 /*
  * Copyright (c) [2004-2010] Novell, Inc.
+ * Copyright (c) 2018 SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -20,8 +21,11 @@
  */
 
 
+#include <boost/algorithm/string.hpp>
+
 #include "storage/Utils/StorageDefines.h"
 #include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/StorageTmpl.h"
 #include "storage/SystemInfo/SystemInfo.h"
 
 
@@ -39,4 +43,125 @@ namespace storage
 	y2deb("destructed SystemInfo");
     }
 
+
+    void
+    SystemInfo::invalidate(const set<string>& names)
+    {
+	y2mil("invalidate names:" << names);
+
+	const auto touched = [&names](const string& name) { return names.find(name) != names.end(); };
+
+	etc_fstab.reset();
+	etc_crypttab.reset();
+	etc_mdadm.reset();
+
+	dirs.clear();
+	files.clear();
+	mdlinks.reset();
+	procmounts.reset();
+	procmdstat.reset();
+	mdadmdetails.erase_if(touched);
+	mdadmexamines.clear();
+	blkid.reset();
+	lsscsi.reset();
+	parteds.erase_if(touched);
+	dasdviews.erase_if(touched);
+	cmd_dmsetup_info.reset();
+	cmd_dmsetup_table.reset();
+	cmd_cryptsetups.clear();
+	cmddmraid.reset();
+	cmdmultipath.reset();
+
+	cmdbtrfsfilesystemshow.reset();
+	cmdbtrfssubvolumelists.erase_if(touched);
+	cmdbtrfssubvolumegetdefaults.erase_if(touched);
+
+	cmdlvmfullreport.reset();
+	cmdpvs.reset();
+	cmdvgs.reset();
+	cmdlvs.reset();
+
+	// The links in /dev/disk can move to other devices, e.g. by-uuid
+	// after creating a filesystem.
+	cmdudevadmdb.reset();
+	cmdudevadminfos.erase_if([&touched](const string& file) {
+	    return touched(file) || boost::starts_with(file, DEVDIR "/disk/");
+	});
+
+	cmddfs.clear();
+
+	cmdlsattr.erase_if([&touched](const CmdLsattr::key_t& key) { return touched(std::get<0>(key)); });
+    }
+
+
+    const vector<string>*
+    SystemInfo::find_names_by_majorminor(dev_t majorminor)
+    {
+	static const vector<string> empty;
+
+	const CmdUdevadmDb* cmd_udevadm_db = get_cmd_udevadm_db_if_available();
+	if (!cmd_udevadm_db)
+	    return nullptr;
+
+	const vector<string>* names = cmd_udevadm_db->find_names_by_majorminor(majorminor);
+	return names ? names : &empty;
+    }
+
+
+    const CmdUdevadmDb*
+    SystemInfo::get_cmd_udevadm_db_if_available()
+    {
+	try
+	{
+	    return &getCmdUdevadmDb();
+	}
+	catch (const Exception& exception)
+	{
+	    // The exception was already logged when the udev database was
+	    // probed. CmdUdevadmInfo falls back to 'udevadm info'.
+	    return nullptr;
+	}
+    }
+
+
+
+    const CmdPvs&
+    SystemInfo::getCmdPvs()
+    {
+	const CmdLvmFullreport* cmd_lvm_fullreport = get_cmd_lvm_fullreport_if_available();
+	return cmd_lvm_fullreport ? cmd_lvm_fullreport->get_cmd_pvs() : cmdpvs.get();
+    }
+
+
+    const CmdVgs&
+    SystemInfo::getCmdVgs()
+    {
+	const CmdLvmFullreport* cmd_lvm_fullreport = get_cmd_lvm_fullreport_if_available();
+	return cmd_lvm_fullreport ? cmd_lvm_fullreport->get_cmd_vgs() : cmdvgs.get();
+    }
+
+
+    const CmdLvs&
+    SystemInfo::getCmdLvs()
+    {
+	const CmdLvmFullreport* cmd_lvm_fullreport = get_cmd_lvm_fullreport_if_available();
+	return cmd_lvm_fullreport ? cmd_lvm_fullreport->get_cmd_lvs() : cmdlvs.get();
+    }
+
+
+    const CmdLvmFullreport*
+    SystemInfo::get_cmd_lvm_fullreport_if_available()
+    {
+	try
+	{
+	    return &cmdlvmfullreport.get();
+	}
+	catch (const Exception& exception)
+	{
+	    // The exception was already logged. Fall back to pvs, vgs and
+	    // lvs.
+	    return nullptr;
+	}
+    }
+
 }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -25,6 +25,9 @@
 #define STORAGE_SYSTEM_INFO_H
 
 
+#include <mutex>
+#include <tuple>
+#include <set>
 #include <boost/noncopyable.hpp>
 
 #include "storage/EtcFstab.h"
@@ -53,6 +56,7 @@
 namespace storage
 {
     using std::map;
+    using std::set;
 
 
     class SystemInfo : private boost::noncopyable
@@ -69,11 +73,23 @@ namespace storage
 	   If the command-line is not stable a key is introduced, e.g. the
 	   device name. So for getCmdBtrfsSubvolumeList() the device name and
 	   the mountpoint have to be specified while the device is only used
-	   as key and the mountpoint only for the command. */
+	   as key and the mountpoint only for the command.
+
+	   All functions are thread-safe so that the Prober can prefetch
+	   objects in parallel. Different objects are created concurrently,
+	   concurrent requests for the same object wait for the first one. */
 
 	SystemInfo();
 	~SystemInfo();
 
+	/* Drops all cached objects that may have changed when the devices
+	   with the given names were modified, so that a SystemInfo can be
+	   reused for the next probe. Objects covering all devices, e.g.
+	   blkid or lvs, are always dropped. Objects for a single device,
+	   e.g. parted, are only dropped for the given devices. Must not
+	   be called concurrently with other functions. */
+	void invalidate(const set<string>& names);
+
 	const EtcFstab& getEtcFstab() { return etc_fstab.get(); }
 	const EtcCrypttab& getEtcCrypttab() { return etc_crypttab.get(); }
 	const EtcMdadm& getEtcMdadm() { return etc_mdadm.get(); }
@@ -106,10 +122,23 @@ namespace storage
 	const CmdBtrfsSubvolumeGetDefault& getCmdBtrfsSubvolumeGetDefault(const string& device, const string& mountpoint)
 	    { return cmdbtrfssubvolumegetdefaults.get(CmdBtrfsSubvolumeGetDefault::key_t(device), mountpoint); }
 
-	const CmdPvs& getCmdPvs() { return cmdpvs.get(); }
-	const CmdVgs& getCmdVgs() { return cmdvgs.get(); }
-	const CmdLvs& getCmdLvs() { return cmdlvs.get(); }
-	const CmdUdevadmInfo& getCmdUdevadmInfo(const string& file) { return cmdudevadminfos.get(file); }
+	// Use 'lvm fullreport' if available.
+	const CmdPvs& getCmdPvs();
+	const CmdVgs& getCmdVgs();
+	const CmdLvs& getCmdLvs();
+	const CmdUdevadmDb& getCmdUdevadmDb() { return cmdudevadmdb.get(); }
+
+	// Uses the udev database if available.
+	const CmdUdevadmInfo& getCmdUdevadmInfo(const string& file)
+	    { return cmdudevadminfos.get(file, get_cmd_udevadm_db_if_available()); }
+
+	/* Returns all names, the device node and all symbolic links, of the
+	   block device with the major and minor number using the udev
+	   database. So resolving an alias is a hash lookup. Returns nullptr
+	   if the udev database is not available. In that case callers have
+	   to compare the major and minor numbers of all candidates. */
+	const vector<string>* find_names_by_majorminor(dev_t majorminor);
+
 	const CmdDf& getCmdDf(const string& mountpoint) { return cmddfs.get(mountpoint); }
 
 	// The device is only used for the cache-key.
@@ -118,9 +147,19 @@ namespace storage
 
     private:
 
+	/* Returns nullptr if the udev database is not available, e.g. when
+	   the command is missing in a mockup file. */
+	const CmdUdevadmDb* get_cmd_udevadm_db_if_available();
+
+	/* Returns nullptr if 'lvm fullreport' is not available, e.g. with
+	   older LVM versions or when the command is missing in a mockup
+	   file. */
+	const CmdLvmFullreport* get_cmd_lvm_fullreport_if_available();
+
 	/* LazyObject, LazyObjects and LazyObjectsWithKey cache the object and
 	   a potential exception during object construction. HelperBase does
-	   the common part. */
+	   the common part. The mutex of HelperBase protects the object, the
+	   mutex of LazyObjects and LazyObjectsWithKey only the map. */
 
 	template <class Object, typename... Args>
 	class HelperBase
@@ -129,6 +168,8 @@ namespace storage
 
 	    const Object& get(Args... args)
 	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		if (e)
 		    std::rethrow_exception(e);
 
@@ -138,7 +179,7 @@ namespace storage
 		    {
 			object.reset(new Object(args...));
 		    }
-		    catch (std::exception)
+		    catch (const std::exception&)
 		    {
 			e = std::current_exception();
 			std::rethrow_exception(e);
@@ -148,8 +189,18 @@ namespace storage
 		return *object;
 	    }
 
+	    void reset()
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
+		object.reset();
+		e = nullptr;
+	    }
+
 	private:
 
+	    std::mutex mutex;
+
 	    std::shared_ptr<Object> object;
 	    std::exception_ptr e;
 
@@ -162,6 +213,24 @@ namespace storage
 	};
 
 
+	/* Erases the entries with keys fulfilling pred from data. Used for
+	   LazyObjects and LazyObjectsWithKey. */
+
+	template <class Key, class Helper, class Pred>
+	static void erase_if(map<Key, Helper>& data, std::mutex& mutex, Pred pred)
+	{
+	    std::lock_guard<std::mutex> lock(mutex);
+
+	    for (typename map<Key, Helper>::iterator it = data.begin(); it != data.end(); )
+	    {
+		if (pred(it->first))
+		    it = data.erase(it);
+		else
+		    ++it;
+	    }
+	}
+
+
 	template <class Object, class Arg = string>
 	class LazyObjects : private boost::noncopyable
 	{
@@ -171,13 +240,34 @@ namespace storage
 
 	    const Object& get(const Arg& arg)
 	    {
+		return find_or_insert(arg).get(arg);
+	    }
+
+	    template <class Pred>
+	    void erase_if(Pred pred)
+	    {
+		SystemInfo::erase_if(data, mutex, pred);
+	    }
+
+	    void clear()
+	    {
+		erase_if([](const Arg&) { return true; });
+	    }
+
+	private:
+
+	    Helper& find_or_insert(const Arg& arg)
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		typename map<Arg, Helper>::iterator pos = data.lower_bound(arg);
 		if (pos == data.end() || typename map<Arg, Helper>::key_compare()(arg, pos->first))
-		    pos = data.insert(pos, typename map<Arg, Helper>::value_type(arg, Helper()));
-		return pos->second.get(arg);
+		    pos = data.emplace_hint(pos, std::piecewise_construct, std::forward_as_tuple(arg),
+					    std::forward_as_tuple());
+		return pos->second;
 	    }
 
-	private:
+	    std::mutex mutex;
 
 	    map<Arg, Helper> data;
 
@@ -195,19 +285,42 @@ namespace storage
 
 	    bool includes(const Key& key) const
 	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		typename map<Key, Helper>::const_iterator pos = data.lower_bound(key);
 		return pos != data.end() && !typename map<Key, Helper>::key_compare()(key, pos->first);
 	    }
 
 	    const Object& get(const Key& key, Args... args)
 	    {
+		return find_or_insert(key).get(key, args...);
+	    }
+
+	    template <class Pred>
+	    void erase_if(Pred pred)
+	    {
+		SystemInfo::erase_if(data, mutex, pred);
+	    }
+
+	    void clear()
+	    {
+		erase_if([](const Key&) { return true; });
+	    }
+
+	private:
+
+	    Helper& find_or_insert(const Key& key)
+	    {
+		std::lock_guard<std::mutex> lock(mutex);
+
 		typename map<Key, Helper>::iterator pos = data.lower_bound(key);
 		if (pos == data.end() || typename map<Key, Helper>::key_compare()(key, pos->first))
-		    pos = data.insert(pos, typename map<Key, Helper>::value_type(key, Helper()));
-		return pos->second.get(key, args...);
+		    pos = data.emplace_hint(pos, std::piecewise_construct, std::forward_as_tuple(key),
+					    std::forward_as_tuple());
+		return pos->second;
 	    }
 
-	private:
+	    mutable std::mutex mutex;
 
 	    map<Key, Helper> data;
 
@@ -239,11 +352,13 @@ namespace storage
 	LazyObjectsWithKey<CmdBtrfsSubvolumeList, string> cmdbtrfssubvolumelists;
 	LazyObjectsWithKey<CmdBtrfsSubvolumeGetDefault, string> cmdbtrfssubvolumegetdefaults;
 
+	LazyObject<CmdLvmFullreport> cmdlvmfullreport;
 	LazyObject<CmdPvs> cmdpvs;
 	LazyObject<CmdVgs> cmdvgs;
 	LazyObject<CmdLvs> cmdlvs;
 
-	LazyObjects<CmdUdevadmInfo> cmdudevadminfos;
+	LazyObject<CmdUdevadmDb> cmdudevadmdb;
+	LazyObjectsWithKey<CmdUdevadmInfo, const CmdUdevadmDb*> cmdudevadminfos;
 	LazyObjects<CmdDf> cmddfs;
 
 	LazyObjectsWithKey<CmdLsattr, string, string> cmdlsattr;
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -23,6 +23,9 @@
 
 #include <string.h>
 #include <unistd.h>
+#include <poll.h>
+#include <sys/inotify.h>
+#include <algorithm>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/Utils/FileUtils.h"
@@ -112,4 +115,108 @@ namespace storage
 	}
     }
 
+
+    namespace
+    {
+
+	bool
+	file_exists(const string& name)
+	{
+	    return access(name.c_str(), R_OK) == 0;
+	}
+
+
+	/**
+	 * Removes the existing files from names.
+	 */
+	void
+	remove_existing_files(vector<string>& names)
+	{
+	    names.erase(remove_if(names.begin(), names.end(), file_exists), names.end());
+	}
+
+
+	/**
+	 * Returns the nearest existing ancestor directory of name. Watching
+	 * that directory notices when the next missing path component
+	 * gets created, e.g. /dev/mapper or /dev/md.
+	 */
+	string
+	existing_ancestor(const string& name)
+	{
+	    string ancestor = dirname(name);
+
+	    while (ancestor != "/" && ancestor != "." && access(ancestor.c_str(), F_OK) != 0)
+		ancestor = dirname(ancestor);
+
+	    return ancestor;
+	}
+
+    }
+
+
+    vector<string>
+    wait_for_files(const vector<string>& names, std::chrono::milliseconds timeout)
+    {
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + timeout;
+
+	vector<string> missing = names;
+	remove_existing_files(missing);
+
+	if (missing.empty())
+	    return missing;
+
+	int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (fd < 0)
+	    y2err("inotify_init1 failed, " << Exception::strErrno(errno));
+
+	while (true)
+	{
+	    // The watches are (re)added before checking the files to avoid
+	    // missing a creation in between. Adding an existing watch is
+	    // harmless.
+
+	    if (fd >= 0)
+	    {
+		for (const string& name : missing)
+		{
+		    if (inotify_add_watch(fd, existing_ancestor(name).c_str(), IN_CREATE | IN_MOVED_TO |
+					  IN_ATTRIB | IN_ONLYDIR) < 0)
+			y2war("inotify_add_watch failed for " << name << ", " << Exception::strErrno(errno));
+		}
+	    }
+
+	    remove_existing_files(missing);
+	    if (missing.empty())
+		break;
+
+	    const std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	    if (now >= deadline)
+		break;
+
+	    int remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - now).count() + 1;
+
+	    if (fd < 0)
+	    {
+		// Fallback without inotify.
+		usleep(1000 * std::min(remaining, 10));
+		continue;
+	    }
+
+	    struct pollfd pfd = { fd, POLLIN, 0 };
+	    if (poll(&pfd, 1, remaining) > 0)
+	    {
+		// The events are only used as wakeup.
+		char buffer[4096];
+		while (read(fd, buffer, sizeof(buffer)) > 0)
+		    ;
+	    }
+	}
+
+	if (fd >= 0)
+	    close(fd);
+
+	return missing;
+    }
+
 }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -27,6 +27,7 @@
 
 #include <string>
 #include <vector>
+#include <chrono>
 #include <boost/noncopyable.hpp>
 
 
@@ -94,6 +95,15 @@ namespace storage
 
     };
 
+
+    /**
+     * Waits until all files exist and are readable, e.g. device nodes
+     * created by the kernel or udev. Uses inotify on the directories of
+     * the files and thus does not poll. Returns the files still missing
+     * after the timeout.
+     */
+    vector<string> wait_for_files(const vector<string>& names, std::chrono::milliseconds timeout);
+
 }
 
 #endif
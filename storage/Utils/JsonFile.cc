@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -20,8 +20,6 @@
  */
 
 
-#include <functional>
-#include <memory>
 #include <sstream>
 
 #include "storage/Utils/JsonFile.h"
@@ -32,21 +30,19 @@
 namespace storage
 {
 
-    JsonFile::JsonFile(const vector<string>& lines)
-	: root(nullptr)
+    JsonFile::JsonFile()
+	: tokener(json_tokener_new(), json_tokener_free), root(nullptr), failed(false)
     {
-	std::unique_ptr<json_tokener, std::function<void(json_tokener*)>> tokener(
-	    json_tokener_new(), [](json_tokener* p) { json_tokener_free(p); }
-	);
+    }
 
+
+    JsonFile::JsonFile(const vector<string>& lines)
+	: JsonFile()
+    {
 	for (const string& line : lines)
-	{
-	    root = json_tokener_parse_ex(tokener.get(), line.c_str(), line.size());
+	    parse(line.c_str(), line.size());
 
-	    json_tokener_error jerr = json_tokener_get_error(tokener.get());
-	    if (jerr != json_tokener_success && jerr != json_tokener_continue)
-		ST_THROW(Exception("json parser failed"));
-	}
+	get_root();
     }
 
 
@@ -56,6 +52,54 @@ namespace storage
     }
 
 
+    json_object*
+    JsonFile::get_root() const
+    {
+	if (failed)
+	    ST_THROW(Exception("json parser failed"));
+
+	return root;
+    }
+
+
+    void
+    JsonFile::reset()
+    {
+	json_tokener_reset(tokener.get());
+
+	json_object_put(root);
+	root = nullptr;
+
+	failed = false;
+    }
+
+
+    void
+    JsonFile::process(const string& txt, bool stderr)
+    {
+	if (!stderr)
+	    parse(txt.c_str(), txt.size());
+    }
+
+
+    void
+    JsonFile::parse(const char* data, size_t size)
+    {
+	// The input is fed in chunks. Once the object is complete the
+	// tokener only sees trailing whitespace, which must not replace the
+	// root.
+
+	if (failed || root)
+	    return;
+
+	root = json_tokener_parse_ex(tokener.get(), data, size);
+
+	json_tokener_error jerr = json_tokener_get_error(tokener.get());
+	if (jerr != json_tokener_success && jerr != json_tokener_continue)
+	    failed = true;
+    }
+
+
     template<>
     bool
     get_child_value(json_object* parent, const char* name, string& value)
@@ -118,19 +162,15 @@ namespace storage
 
 
     bool
-    get_child_nodes(json_object* parent, const char* name, vector<json_object*>& children)
+    for_each_child_node(json_object* parent, const char* name, const std::function<void(json_object*)>& func)
     {
 	json_object* tmp;
-        json_object_object_get_ex(parent, name, &tmp);
-
-        if (!json_object_is_type(tmp, json_type_array))
+	if (!json_object_object_get_ex(parent, name, &tmp) || !json_object_is_type(tmp, json_type_array))
 	    return false;
 
-	children.clear();
-
 	size_t s = json_object_array_length(tmp);
 	for (size_t i = 0; i < s; ++i)
-	    children.push_back(json_object_array_get_idx(tmp, i));
+	    func(json_object_array_get_idx(tmp, i));
 
 	return true;
     }
@@ -1,5 +1,5 @@
 /*
- * Copyright (c) 2017 SUSE LLC
+ * Copyright (c) [2017-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -25,31 +25,55 @@
 
 
 #include <json-c/json.h>
+#include <functional>
+#include <memory>
 #include <string>
 #include <vector>
 #include <boost/noncopyable.hpp>
 
+#include "storage/Utils/OutputProcessor.h"
+
 
 namespace storage
 {
     using namespace std;
 
 
-    class JsonFile : private boost::noncopyable
+    /**
+     * Parses JSON either from lines or, when used as stdout processor for
+     * SystemCmd, directly from the output of the command while reading it.
+     */
+    class JsonFile : public OutputProcessor, private boost::noncopyable
     {
 
     public:
 
+	JsonFile();
+
 	JsonFile(const vector<string>& lines);
 
 	~JsonFile();
 
-	json_object* get_root() const { return root; }
+	/**
+	 * Returns nullptr if the input was empty or incomplete. Throws if
+	 * parsing failed.
+	 */
+	json_object* get_root() const;
+
+	virtual void reset() override;
+	virtual void finish() override {}
+	virtual void process(const string& txt, bool stderr) override;
 
     private:
 
+	void parse(const char* data, size_t size);
+
+	std::unique_ptr<json_tokener, void(*)(json_tokener*)> tokener;
+
 	json_object* root;
 
+	bool failed;
+
     };
 
 
@@ -57,8 +81,12 @@ namespace storage
     bool get_child_value(json_object* parent, const char* name, Type& value);
 
 
+    /**
+     * Calls func for every element of the array child with the name. Returns
+     * false if there is no such array child.
+     */
     bool
-    get_child_nodes(json_object* parent, const char* name, vector<json_object*>& children);
+    for_each_child_node(json_object* parent, const char* name, const std::function<void(json_object*)>& func);
 
 }
 
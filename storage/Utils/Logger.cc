@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -22,8 +22,12 @@
 
 
 #include <iostream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
 
-#include "storage/Utils/Logger.h"
+#include "storage/Utils/LoggerImpl.h"
 #include "storage/Utils/AppUtil.h"
 
 
@@ -121,6 +125,164 @@ namespace storage
     }
 
 
+    BufferedLogfileLogger::BufferedLogfileLogger(const std::string& filename)
+	: filename(filename)
+    {
+	buffer.reserve(high_watermark);
+    }
+
+
+    BufferedLogfileLogger::~BufferedLogfileLogger()
+    {
+	stop();
+    }
+
+
+    void
+    BufferedLogfileLogger::write(LogLevel log_level, const std::string& component, const std::string& file,
+				 int line, const std::string& function, const std::string& content)
+    {
+	std::string tmp = datetime(time(nullptr)) + " <" +
+	    std::to_string(static_cast<log_level_underlying_type>(log_level)) + "> [" + component + "] " +
+	    file + "(" + function + "):" + std::to_string(line) + " " + content + "\n";
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (stopping)
+	{
+	    write_directly(tmp);
+	    return;
+	}
+
+	if (!thread.joinable())
+	    thread = std::thread(&BufferedLogfileLogger::writer, this);
+
+	data_written.wait(lock, [this] { return buffer.size() < 2 * high_watermark || stopping; });
+
+	buffer += tmp;
+	requested += tmp.size();
+
+	if (log_level == LogLevel::ERROR || buffer.size() >= high_watermark)
+	{
+	    urgent = true;
+	    data_available.notify_one();
+	}
+    }
+
+
+    void
+    BufferedLogfileLogger::flush()
+    {
+	std::unique_lock<std::mutex> lock(mutex);
+
+	if (!thread.joinable())
+	    return;
+
+	const unsigned long long target = requested;
+
+	urgent = true;
+	data_available.notify_one();
+
+	data_written.wait(lock, [this, target] { return written >= target || stopping; });
+    }
+
+
+    void
+    BufferedLogfileLogger::stop()
+    {
+	{
+	    std::lock_guard<std::mutex> lock(mutex);
+
+	    if (stopping)
+		return;
+
+	    stopping = true;
+	}
+
+	data_available.notify_one();
+
+	// The writer thread writes the remaining buffer before it ends.
+
+	if (thread.joinable())
+	    thread.join();
+    }
+
+
+    void
+    BufferedLogfileLogger::writer()
+    {
+	FILE* f = fopen(filename.c_str(), "ae");
+
+	std::string tmp;
+	tmp.reserve(high_watermark);
+
+	std::unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+	    // Without explicit request the buffer is written every 100 ms.
+	    data_available.wait_for(lock, std::chrono::milliseconds(100),
+				    [this] { return urgent || stopping; });
+
+	    urgent = false;
+
+	    tmp.swap(buffer);
+	    unsigned long long size = tmp.size();
+
+	    lock.unlock();
+
+	    if (f && !tmp.empty())
+	    {
+		fwrite(tmp.data(), 1, tmp.size(), f);
+		fflush(f);
+	    }
+
+	    tmp.clear();
+
+	    lock.lock();
+
+	    written += size;
+	    data_written.notify_all();
+
+	    if (stopping && buffer.empty())
+		break;
+	}
+
+	if (f)
+	    fclose(f);
+    }
+
+
+    void
+    BufferedLogfileLogger::write_directly(const std::string& data) const
+    {
+	FILE* f = fopen(filename.c_str(), "ae");
+	if (f)
+	{
+	    fwrite(data.data(), 1, data.size(), f);
+	    fclose(f);
+	}
+    }
+
+
+    Logger*
+    get_buffered_logfile_logger()
+    {
+	// The logger is never destroyed since objects with static storage
+	// duration may still log while being destroyed. Instead the
+	// background thread is stopped at exit and afterwards log lines
+	// are written directly.
+
+	static BufferedLogfileLogger* buffered_logfile_logger = []() {
+	    BufferedLogfileLogger* tmp = new BufferedLogfileLogger("/var/log/libstorage-ng.log");
+	    atexit([]() { static_cast<BufferedLogfileLogger*>(get_buffered_logfile_logger())->stop(); });
+	    return tmp;
+	}();
+
+	return buffered_logfile_logger;
+    }
+
+
     Silencer::Silencer()
 	: active(false)
     {
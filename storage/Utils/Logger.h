@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -82,12 +82,24 @@ namespace storage
 
     /**
      * Returns a Logger that logs to the standard libstorage log file
-     * ("/var/log/libstorage.log"). Do not use this function for production
-     * code but only for examples and test-cases.
+     * ("/var/log/libstorage-ng.log"). Do not use this function for
+     * production code but only for examples and test-cases.
      */
     Logger* get_logfile_logger();
 
 
+    /**
+     * Returns a Logger that logs to the standard libstorage log file
+     * ("/var/log/libstorage-ng.log"). Unlike the logger returned by
+     * get_logfile_logger() the log file is kept open and the log lines
+     * are buffered and written by a background thread. The buffer is
+     * written after probing and committing, when a line with log-level
+     * ERROR is logged and at program exit. Log lines after program exit
+     * started are written directly.
+     */
+    Logger* get_buffered_logfile_logger();
+
+
     /**
      * Class to make some exceptions log-level DEBUG instead of WARNING.
      */
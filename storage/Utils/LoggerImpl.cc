@@ -1,6 +1,6 @@
 /*
  * Copyright (c) 2015 Novell, Inc.
- * Copyright (c) 2016 SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -21,6 +21,10 @@
  */
 
 
+#include <memory>
+#include <vector>
+#include <locale>
+
 #include "storage/Utils/LoggerImpl.h"
 
 
@@ -45,46 +49,158 @@ namespace storage
     }
 
 
-    void
-    prepare_log_stream(ostringstream& stream)
+    namespace
     {
-	stream.imbue(std::locale::classic());
-	stream.setf(std::ios::boolalpha);
-	stream.setf(std::ios::showbase);
+
+	/**
+	 * Stream buffer appending to a string. Unlike std::stringbuf the
+	 * content can be accessed without a copy and the string keeps its
+	 * capacity when cleared.
+	 */
+	class LogStreamBuf : public streambuf
+	{
+	public:
+
+	    string content;
+
+	protected:
+
+	    virtual int_type overflow(int_type c) override
+	    {
+		if (!traits_type::eq_int_type(c, traits_type::eof()))
+		    content += traits_type::to_char_type(c);
+
+		return traits_type::not_eof(c);
+	    }
+
+	    virtual streamsize xsputn(const char* s, streamsize n) override
+	    {
+		content.append(s, n);
+		return n;
+	    }
+
+	};
+
+
+	class LogStream : public ostream
+	{
+	public:
+
+	    LogStream(size_t index)
+		: ostream(&buf), index(index)
+	    {
+		imbue(std::locale::classic());
+	    }
+
+	    void reset()
+	    {
+		buf.content.clear();
+
+		clear();
+		flags(ios::boolalpha | ios::showbase | ios::dec | ios::skipws);
+		width(0);
+		precision(6);
+		fill(' ');
+	    }
+
+	    LogStreamBuf buf;
+
+	    /**
+	     * Used when the content has to be split into several lines.
+	     */
+	    string line;
+
+	    const size_t index;
+
+	};
+
+
+	/**
+	 * The log streams of a thread. Usually only the first one is used
+	 * but logging can happen while the content of a log statement is
+	 * formatted.
+	 */
+	struct LogStreams
+	{
+	    vector<unique_ptr<LogStream>> streams;
+	    size_t depth = 0;
+	};
+
+
+	thread_local LogStreams log_streams;
+
     }
 
 
-    ostringstream*
+    ostream*
     open_log_stream()
     {
-	std::ostringstream* stream = new ostringstream;
-	prepare_log_stream(*stream);
+	LogStreams& tmp = log_streams;
+
+	if (tmp.depth == tmp.streams.size())
+	    tmp.streams.emplace_back(new LogStream(tmp.depth));
+
+	LogStream* stream = tmp.streams[tmp.depth++].get();
+	stream->reset();
+
 	return stream;
     }
 
 
     void
     close_log_stream(LogLevel log_level, const char* file, unsigned line, const char* func,
-		     ostringstream* stream)
+		     ostream* stream)
     {
+	LogStream* log_stream = static_cast<LogStream*>(stream);
+
+	// Using the index of the stream instead of just decrementing the
+	// depth also recovers from exceptions thrown while formatting. The
+	// stream stays in use until the logger is done since the logger
+	// might log itself.
+	log_streams.depth = log_stream->index + 1;
+
 	Logger* logger = get_logger();
 	if (logger)
 	{
-	    string content = stream->str();
-	    string::size_type pos1 = 0;
-	    while (true)
+	    const string& content = log_stream->buf.content;
+
+	    string::size_type pos2 = content.find('\n');
+	    if (pos2 == string::npos)
+	    {
+		if (!content.empty())
+		    logger->write(log_level, component, file, line, func, content);
+	    }
+	    else
 	    {
-		string::size_type pos2 = content.find('\n', pos1);
-		if (pos2 != string::npos || pos1 != content.length())
-		    logger->write(log_level, component, file, line, func,
-				  content.substr(pos1, pos2 - pos1));
-		if (pos2 == string::npos)
-		    break;
-		pos1 = pos2 + 1;
+		string::size_type pos1 = 0;
+		while (true)
+		{
+		    if (pos2 != string::npos || pos1 != content.length())
+		    {
+			log_stream->line.assign(content, pos1, pos2 - pos1);
+			logger->write(log_level, component, file, line, func, log_stream->line);
+		    }
+		    if (pos2 == string::npos)
+			break;
+		    pos1 = pos2 + 1;
+		    pos2 = content.find('\n', pos1);
+		}
 	    }
 	}
 
-	delete stream;
+	log_streams.depth = log_stream->index;
+    }
+
+
+    void
+    flush_log()
+    {
+	// Only the buffered logfile logger needs flushing. Other loggers,
+	// e.g. implemented in the bindings, write every line immediately.
+
+	BufferedLogfileLogger* buffered_logfile_logger = dynamic_cast<BufferedLogfileLogger*>(get_logger());
+	if (buffered_logfile_logger)
+	    buffered_logfile_logger->flush();
     }
 
 }
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2014-2015] Novell, Inc.
- * Copyright (c) 2016 SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -26,6 +26,10 @@
 
 
 #include <sstream>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
 
 #include "storage/Utils/Logger.h"
 
@@ -35,10 +39,83 @@ namespace storage
 
     bool query_log_level(LogLevel log_level);
 
-    std::ostringstream* open_log_stream();
+    /**
+     * Returns a stream to format a log statement into. The stream is
+     * thread-local and reused so that in general logging does not
+     * allocate memory.
+     */
+    std::ostream* open_log_stream();
 
     void close_log_stream(LogLevel log_level, const char* file, unsigned line,
-			  const char* func, std::ostringstream*);
+			  const char* func, std::ostream*);
+
+    /**
+     * Flushes the log lines buffered by the logger, if any.
+     */
+    void flush_log();
+
+
+    /**
+     * Logger used by get_buffered_logfile_logger(). Log lines are
+     * buffered and written by a background thread.
+     */
+    class BufferedLogfileLogger : public Logger
+    {
+    public:
+
+	BufferedLogfileLogger(const std::string& filename);
+	virtual ~BufferedLogfileLogger();
+
+	virtual void write(LogLevel log_level, const std::string& component, const std::string& file,
+			   int line, const std::string& function, const std::string& content) override;
+
+	/**
+	 * Waits until all log lines logged so far are written.
+	 */
+	void flush();
+
+	/**
+	 * Writes the buffer and stops the background thread. Afterwards
+	 * log lines are written directly.
+	 */
+	void stop();
+
+    private:
+
+	void writer();
+
+	void write_directly(const std::string& data) const;
+
+	/**
+	 * The writer thread is woken up when the buffer exceeds this size.
+	 * Above the double size write() blocks until the buffer is written.
+	 */
+	static const size_t high_watermark = 256 * 1024;
+
+	const std::string filename;
+
+	std::mutex mutex;
+	std::condition_variable data_available;
+	std::condition_variable data_written;
+
+	std::thread thread;
+
+	/**
+	 * Filled by write(). The writer thread swaps it with its own buffer
+	 * so that the file is written without holding the mutex.
+	 */
+	std::string buffer;
+
+	/**
+	 * Number of bytes passed to write() and written to the file.
+	 */
+	unsigned long long written = 0;
+	unsigned long long requested = 0;
+
+	bool urgent = false;
+	bool stopping = false;
+
+    };
 
 #define y2deb(op) y2log_op(storage::LogLevel::DEBUG, __FILE__, __LINE__, __FUNCTION__, op)
 #define y2mil(op) y2log_op(storage::LogLevel::MILESTONE, __FILE__, __LINE__, __FUNCTION__, op)
@@ -49,7 +126,7 @@ namespace storage
     do {									\
 	if (storage::query_log_level(log_level))				\
 	{									\
-	    std::ostringstream* __buf = storage::open_log_stream();		\
+	    std::ostream* __buf = storage::open_log_stream();			\
 	    *__buf << op;							\
 	    storage::close_log_stream(log_level, file, line, func, __buf);	\
 	}									\
@@ -33,6 +33,8 @@ namespace storage
     void
     Mockup::load(const string& filename)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	XmlFile xml(filename);
 
 	const xmlNode* root_node = xml.getRootElement();
@@ -80,6 +82,8 @@ namespace storage
     void
     Mockup::save(const string& filename)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	XmlFile xml;
 
 	xmlNode* mockup_node = xmlNewNode("Mockup");
@@ -117,6 +121,8 @@ namespace storage
     bool
     Mockup::has_command(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	return commands.find(name) != commands.end();
     }
 
@@ -124,6 +130,8 @@ namespace storage
     const Mockup::Command&
     Mockup::get_command(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	map<string, Command>::const_iterator it = commands.find(name);
 	if (it == commands.end())
 	    ST_THROW(Exception("no mockup found for command '" + name + "'"));
@@ -139,6 +147,8 @@ namespace storage
     void
     Mockup::set_command(const string& name, const Command& command)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	commands[name] = command;
     }
 
@@ -146,6 +156,8 @@ namespace storage
     void
     Mockup::erase_command(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	commands.erase(name);
     }
 
@@ -153,6 +165,8 @@ namespace storage
     bool
     Mockup::has_file(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	return files.find(name) != files.end();
     }
 
@@ -160,6 +174,8 @@ namespace storage
     const Mockup::File&
     Mockup::get_file(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	map<string, File>::const_iterator it = files.find(name);
 	if (it == files.end())
 	    ST_THROW(Exception("no mockup found for file '" + name + "'"));
@@ -175,6 +191,8 @@ namespace storage
     void
     Mockup::set_file(const string& name, const File& file)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	files[name] = file;
     }
 
@@ -182,6 +200,8 @@ namespace storage
     void
     Mockup::erase_file(const string& name)
     {
+	std::lock_guard<std::mutex> lock(mutex);
+
 	files.erase(name);
     }
 
@@ -220,6 +240,8 @@ namespace storage
 
     Mockup::Mode Mockup::mode = Mockup::Mode::NONE;
 
+    std::mutex Mockup::mutex;
+
     map<string, Mockup::Command> Mockup::commands;
     map<string, Mockup::File> Mockup::files;
 
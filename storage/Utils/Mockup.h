@@ -28,6 +28,7 @@
 #include <string>
 #include <map>
 #include <set>
+#include <mutex>
 
 #include "storage/Utils/Remote.h"
 
@@ -76,6 +77,10 @@ namespace storage
 
 	static Mode mode;
 
+	// Protects commands and files since commands may be executed in
+	// parallel, e.g. during probing.
+	static std::mutex mutex;
+
 	static map<string, Command> commands;
 	static map<string, File> files;
 
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -44,6 +44,8 @@
 
 #define MDADMBIN "/sbin/mdadm"
 
+#define LVMBIN "/sbin/lvm"
+
 #define PVCREATEBIN "/sbin/pvcreate"
 #define PVREMOVEBIN "/sbin/pvremove"
 #define PVRESIZEBIN "/sbin/pvresize"
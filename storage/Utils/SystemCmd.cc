@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -21,10 +21,12 @@
  */
 
 
+#include "config.h"
 #include <stdlib.h>
 #include <unistd.h>
 #include <errno.h>
 #include <fcntl.h>
+#include <spawn.h>
 #include <ostream>
 #include <fstream>
 #include <sys/wait.h>
@@ -39,6 +41,7 @@
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/OutputProcessor.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/ThreadPool.h"
 
 
 #define SYSCALL_FAILED( SYSCALL_MSG ) \
@@ -89,6 +92,12 @@ namespace storage
     }
 
 
+    SystemCmd::SystemCmd(const vector<string>& args, ThrowBehaviour throw_behaviour)
+	: SystemCmd(SystemCmd::Options(args, throw_behaviour))
+    {
+    }
+
+
     void
     SystemCmd::init()
     {
@@ -132,6 +141,13 @@ namespace storage
     void
     SystemCmd::closeOpenFds() const
     {
+#ifdef HAVE_CLOSE_RANGE
+	// close_range() needs Linux 5.9. Fall back to closing the fds one
+	// by one on older kernels.
+	if (close_range(3, ~0U, 0) == 0)
+	    return;
+#endif
+
 	int max_fd = getdtablesize();
 
 	for ( int fd = 3; fd < max_fd; fd++ )
@@ -152,6 +168,7 @@ namespace storage
 	    _outputLines[IDX_STDOUT] = mockup_command.stdout;
 	    _outputLines[IDX_STDERR] = mockup_command.stderr;
 	    _cmdRet = mockup_command.exit_code;
+	    processStdoutLines();
 	    return 0;
 	}
 
@@ -163,6 +180,7 @@ namespace storage
 	    _outputLines[IDX_STDOUT] = remote_command.stdout;
 	    _outputLines[IDX_STDERR] = remote_command.stderr;
 	    _cmdRet = remote_command.exit_code;
+	    processStdoutLines();
 	    ret = 0;
 	}
 	else
@@ -260,6 +278,10 @@ namespace storage
 	{
 	    _outputProc->reset();
 	}
+	if (options.stdout_processor)
+	{
+	    options.stdout_processor->reset();
+	}
 	y2deb("command:" << command());
 
 	Stopwatch stopwatch;
@@ -307,7 +329,15 @@ namespace storage
 		}
 	    }
 	    y2deb("sout:" << _pfds[1].fd << " serr:" << (_combineOutput?-1:_pfds[2].fd));
-	    switch( (_cmdPid=fork()) )
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+	    if (!options.args.empty())
+		_cmdPid = doSpawn(sin, sout, serr);
+	    else
+#endif
+		_cmdPid = fork();
+
+	    switch (_cmdPid)
 	    {
 		case 0: // child process
 		    setenv( "LC_ALL", "C", 1 );
@@ -342,6 +372,20 @@ namespace storage
 			SYSCALL_FAILED_NOTHROW( "close( stderr ) failed in child process" );
 		    }
 		    closeOpenFds();
+
+		    if (!options.args.empty())
+		    {
+			vector<char*> argv;
+			for (const string& arg : options.args)
+			    argv.push_back(const_cast<char*>(arg.c_str()));
+			argv.push_back(nullptr);
+
+			execvp(argv[0], argv.data());
+
+			// Report like the shell would do.
+			exit(errno == ENOENT ? SHELL_RET_COMMAND_NOT_FOUND : SHELL_RET_COMMAND_NOT_EXECUTABLE);
+		    }
+
 		    _cmdRet = execl(SHBIN, SHBIN, "-c", command().c_str(), nullptr);
 
 		    // execl() should not return. If we get here, it failed.
@@ -355,6 +399,41 @@ namespace storage
 		    break;
 
 		case -1:
+		    if (!options.args.empty())
+		    {
+			// posix_spawn() also fails if the program cannot be
+			// executed. Report like the shell would do.
+			int spawn_errno = errno;
+
+			close(sin[0]);
+			close(sin[1]);
+			close(sout[0]);
+			close(sout[1]);
+			if (!_combineOutput)
+			{
+			    close(serr[0]);
+			    close(serr[1]);
+			}
+
+			if (spawn_errno == ENOENT)
+			{
+			    _cmdRet = SHELL_RET_COMMAND_NOT_FOUND;
+			    ST_MAYBE_THROW(CommandNotFoundException(this), do_throw());
+			}
+			else if (spawn_errno == EACCES || spawn_errno == ENOEXEC)
+			{
+			    _cmdRet = SHELL_RET_COMMAND_NOT_EXECUTABLE;
+			    ST_MAYBE_THROW(SystemCmdException(this, "Command not executable"), do_throw());
+			}
+			else
+			{
+			    _cmdRet = -1;
+			    errno = spawn_errno;
+			    SYSCALL_FAILED( "posix_spawn() failed" );
+			}
+			break;
+		    }
+
 		    _cmdRet = -1;
 		    SYSCALL_FAILED( "fork() failed" );
 		    break;
@@ -395,7 +474,11 @@ namespace storage
 		    }
 		    if ( !_execInBackground )
 		    {
-			doWait( true, _cmdRet );
+			{
+			    // Let other threads continue while waiting.
+			    SerialLock::Release release;
+			    doWait( true, _cmdRet );
+			}
 			y2mil("stopwatch " << stopwatch << " for \"" << command() << "\"");
 		    }
 		    break;
@@ -416,6 +499,8 @@ namespace storage
 	}
 	if ( !_testmode )
 	    checkOutput();
+	if (options.stdout_processor)
+	    options.stdout_processor->finish();
 	y2mil("system() Returns:" << _cmdRet);
 	if ( _cmdRet!=0 )
 	    logOutput();
@@ -423,6 +508,54 @@ namespace storage
     }
 
 
+    int
+    SystemCmd::doSpawn(int sin[2], int sout[2], int serr[2]) const
+    {
+	vector<char*> argv;
+	for (const string& arg : options.args)
+	    argv.push_back(const_cast<char*>(arg.c_str()));
+	argv.push_back(nullptr);
+
+	// Same environment as for the forked child.
+	vector<char*> envp;
+	for (char** p = environ; *p; ++p)
+	{
+	    if (!boost::starts_with(*p, "LC_ALL=") && !boost::starts_with(*p, "LANGUAGE="))
+		envp.push_back(*p);
+	}
+	envp.push_back(const_cast<char*>("LC_ALL=C"));
+	envp.push_back(const_cast<char*>("LANGUAGE=C"));
+	envp.push_back(nullptr);
+
+	posix_spawn_file_actions_t file_actions;
+	posix_spawn_file_actions_init(&file_actions);
+
+	posix_spawn_file_actions_adddup2(&file_actions, sin[0], STDIN_FILENO);
+	posix_spawn_file_actions_adddup2(&file_actions, sout[1], STDOUT_FILENO);
+	if (!_combineOutput)
+	    posix_spawn_file_actions_adddup2(&file_actions, serr[1], STDERR_FILENO);
+	else
+	    posix_spawn_file_actions_adddup2(&file_actions, STDOUT_FILENO, STDERR_FILENO);
+
+#ifdef HAVE_POSIX_SPAWN_FILE_ACTIONS_ADDCLOSEFROM_NP
+	posix_spawn_file_actions_addclosefrom_np(&file_actions, 3);
+#endif
+
+	pid_t pid;
+	int ret = posix_spawnp(&pid, argv[0], &file_actions, nullptr, argv.data(), envp.data());
+
+	posix_spawn_file_actions_destroy(&file_actions);
+
+	if (ret != 0)
+	{
+	    errno = ret;
+	    return -1;
+	}
+
+	return pid;
+    }
+
+
     bool
     SystemCmd::doWait( bool hang, int& cmdRet_ret )
     {
@@ -445,9 +578,27 @@ namespace storage
                     sendStdin();
                 if ( _pfds[1].revents || _pfds[2].revents )
                     checkOutput();
+
+		// Once the output is read completely and the command closed
+		// it, poll() would return immediately again. So ignore it
+		// from now on to avoid busy polling.
+		for ( int i = 1; i < ( _combineOutput ? 2 : 3 ); i++ )
+		{
+		    if ( _pfds[i].revents & POLLHUP )
+			_pfds[i].fd = -1;
+		}
 	    }
 	    waitpidRet = waitpid( _cmdPid, &cmdStatus, WNOHANG );
 	    y2deb("Wait ret:" << waitpidRet);
+
+	    // Nothing left to poll for, so wait blocking for the command to
+	    // exit.
+	    if ( hang && waitpidRet == 0 && _pfds[0].fd < 0 && _pfds[1].fd < 0 &&
+		 ( _combineOutput || _pfds[2].fd < 0 ) )
+	    {
+		waitpidRet = waitpid( _cmdPid, &cmdStatus, 0 );
+		y2deb("Wait ret:" << waitpidRet);
+	    }
 	}
 	while ( hang && waitpidRet == 0 );
 
@@ -554,6 +705,21 @@ namespace storage
     SystemCmd::getUntilEOF( FILE* file, vector<string>& lines,
 			    bool& newLineSeen_ret, bool isStderr ) const
     {
+	if (!isStderr && options.stdout_processor && Mockup::get_mode() != Mockup::Mode::RECORD)
+	{
+	    // Pass the raw output in large chunks without splitting it into
+	    // lines. The file is not read via stdio in this case, so reading
+	    // the file descriptor directly is fine.
+
+	    char buffer[64 * 1024];
+	    ssize_t count;
+
+	    while ((count = read(fileno(file), buffer, sizeof(buffer))) > 0)
+		options.stdout_processor->process(string(buffer, count), false);
+
+	    return;
+	}
+
 	size_t oldSize = lines.size();
 	char buffer[BUF_LEN];
 	int count;
@@ -575,6 +741,11 @@ namespace storage
 		{
 		    _outputProc->process( buffer, isStderr );
 		}
+		// Only reached for stdout when recording a mockup.
+		if ( !isStderr && options.stdout_processor )
+		{
+		    options.stdout_processor->process( buffer, false );
+		}
 	    }
 	    c = EOF;
 	}
@@ -586,6 +757,10 @@ namespace storage
 	    {
 		_outputProc->process( buffer, isStderr );
 	    }
+	    if ( !isStderr && options.stdout_processor )
+	    {
+		options.stdout_processor->process( buffer, false );
+	    }
 	}
 	if ( text.length() > 0 )
 	{
@@ -611,6 +786,27 @@ namespace storage
     }
 
 
+    void
+    SystemCmd::processStdoutLines()
+    {
+	// The output from a mockup or remote command is already split into
+	// lines.
+
+	if (!options.stdout_processor)
+	    return;
+
+	options.stdout_processor->reset();
+
+	for (const string& line : _outputLines[IDX_STDOUT])
+	    options.stdout_processor->process(line + "\n", false);
+
+	options.stdout_processor->finish();
+
+	if (Mockup::get_mode() != Mockup::Mode::RECORD)
+	    _outputLines[IDX_STDOUT].clear();
+    }
+
+
     void
     SystemCmd::extractNewline(const string& buffer, int count, bool& newLineSeen_ret,
 			      string& text, vector<string>& lines) const
@@ -1,6 +1,6 @@
 /*
  * Copyright (c) [2004-2015] Novell, Inc.
- * Copyright (c) [2016-2017] SUSE LLC
+ * Copyright (c) [2016-2018] SUSE LLC
  *
  * All Rights Reserved.
  *
@@ -59,14 +59,29 @@ namespace storage
 	struct Options
 	{
 	    Options(const string& command, ThrowBehaviour throw_behaviour = NoThrow)
-		: command(command), throw_behaviour(throw_behaviour), stdin_text(),
-		  mockup_key(), log_line_limit(1000) {}
+		: command(command), args(), throw_behaviour(throw_behaviour), stdin_text(),
+		  mockup_key(), log_line_limit(1000), stdout_processor(nullptr) {}
+
+	    /**
+	     * Constructor for executing the program args[0] with the
+	     * arguments args directly, so without a shell. The command is
+	     * set to the quoted args and used for logging and as mockup key.
+	     */
+	    Options(const vector<string>& args, ThrowBehaviour throw_behaviour = NoThrow)
+		: command(quote(args)), args(args), throw_behaviour(throw_behaviour),
+		  stdin_text(), mockup_key(), log_line_limit(1000), stdout_processor(nullptr) {}
 
 	    /**
 	     * The command to be executed.
 	     */
 	    string command;
 
+	    /**
+	     * The program and its arguments to be executed without a
+	     * shell. If empty the command is executed by the shell.
+	     */
+	    vector<string> args;
+
 	    /**
 	     * Should exceptions be thrown or not?
 	     */
@@ -87,6 +102,14 @@ namespace storage
 	     */
 	    unsigned int log_line_limit;
 
+	    /**
+	     * If set, stdout is passed in chunks as read to the output
+	     * processor instead of being split into lines, so stdout() is
+	     * empty. Useful for large outputs that are parsed anyway.
+	     * Only when recording a mockup the lines are also kept.
+	     */
+	    OutputProcessor* stdout_processor;
+
 	};
 
 	/**
@@ -103,6 +126,14 @@ namespace storage
 	 */
 	SystemCmd(const string& command, ThrowBehaviour throw_behaviour = NoThrow);
 
+	/**
+	 * Convenience constructor where only the program with its arguments
+	 * and the throw behaviour can be specified. The program is executed
+	 * without a shell. Otherwise identical to 'SystemCmd(const Options&
+	 * options)'.
+	 */
+	SystemCmd(const vector<string>& args, ThrowBehaviour throw_behaviour = NoThrow);
+
 	/**
 	 * Destructor.
 	 */
@@ -187,11 +218,13 @@ namespace storage
 	void invalidate();
 	void closeOpenFds() const;
 	int doExecute();
+	int doSpawn(int sin[2], int sout[2], int serr[2]) const;
 	bool doWait(bool hang, int& cmdRet_ret);
 	void checkOutput();
         void sendStdin();
 	void getUntilEOF(FILE* file, std::vector<string>& lines,
 			 bool& newLineSeen_ret, bool isStderr) const;
+	void processStdoutLines();
 	void extractNewline(const string& buffer, int count, bool& newLineSeen_ret,
 			    string& text, std::vector<string>& lines) const;
 	void addLine(const string& text, std::vector<string>& lines) const;
@@ -0,0 +1,168 @@
+/*
+ * Copyright (c) 2018 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#include "storage/Utils/ThreadPool.h"
+
+
+namespace storage
+{
+    using namespace std;
+
+
+    ThreadPool::ThreadPool(unsigned int num_threads)
+	: num_threads(max(num_threads, 1U))
+    {
+    }
+
+
+    ThreadPool::~ThreadPool()
+    {
+	{
+	    unique_lock<std::mutex> lock(mutex);
+	    tasks_done.wait(lock, [this] { return tasks.empty() && num_running == 0; });
+	    stopping = true;
+	}
+
+	task_available.notify_all();
+
+	for (thread& thread : threads)
+	    thread.join();
+    }
+
+
+    void
+    ThreadPool::add_task(const task_t& task)
+    {
+	{
+	    unique_lock<std::mutex> lock(mutex);
+
+	    tasks.push_back(task);
+
+	    if (threads.size() < num_threads && threads.size() < tasks.size() + num_running)
+		threads.emplace_back(&ThreadPool::worker, this);
+	}
+
+	task_available.notify_one();
+    }
+
+
+    void
+    ThreadPool::wait()
+    {
+	unique_lock<std::mutex> lock(mutex);
+
+	tasks_done.wait(lock, [this] { return tasks.empty() && num_running == 0; });
+
+	if (first_exception)
+	{
+	    exception_ptr tmp = first_exception;
+	    first_exception = nullptr;
+	    rethrow_exception(tmp);
+	}
+    }
+
+
+    void
+    ThreadPool::run(const vector<task_t>& tasks, unsigned int num_threads)
+    {
+	ThreadPool thread_pool(min<size_t>(num_threads, tasks.size()));
+
+	for (const task_t& task : tasks)
+	    thread_pool.add_task(task);
+
+	thread_pool.wait();
+    }
+
+
+    void
+    ThreadPool::worker()
+    {
+	unique_lock<std::mutex> lock(mutex);
+
+	while (true)
+	{
+	    task_available.wait(lock, [this] { return stopping || !tasks.empty(); });
+
+	    if (tasks.empty())
+		return;
+
+	    task_t task = tasks.front();
+	    tasks.pop_front();
+	    ++num_running;
+
+	    lock.unlock();
+
+	    exception_ptr e;
+
+	    try
+	    {
+		task();
+	    }
+	    catch (...)
+	    {
+		e = current_exception();
+	    }
+
+	    lock.lock();
+
+	    if (e && !first_exception)
+		first_exception = e;
+
+	    --num_running;
+
+	    if (tasks.empty() && num_running == 0)
+		tasks_done.notify_all();
+	}
+    }
+
+
+    thread_local SerialLock* SerialLock::current = nullptr;
+
+
+    SerialLock::SerialLock(std::mutex& mutex)
+	: lock(mutex)
+    {
+	current = this;
+    }
+
+
+    SerialLock::~SerialLock()
+    {
+	current = nullptr;
+    }
+
+
+    SerialLock::Release::Release()
+	: serial_lock(SerialLock::current)
+    {
+	if (serial_lock)
+	    serial_lock->lock.unlock();
+    }
+
+
+    SerialLock::Release::~Release()
+    {
+	if (serial_lock)
+	    serial_lock->lock.lock();
+    }
+
+}
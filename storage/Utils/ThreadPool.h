@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018 SUSE LLC
+ *
+ * All Rights Reserved.
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of version 2 of the GNU General Public License as published
+ * by the Free Software Foundation.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or
+ * FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for
+ * more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, contact Novell, Inc.
+ *
+ * To contact Novell about this file by physical or electronic mail, you may
+ * find current contact information at www.novell.com.
+ */
+
+
+#ifndef STORAGE_THREAD_POOL_H
+#define STORAGE_THREAD_POOL_H
+
+
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <exception>
+#include <boost/noncopyable.hpp>
+
+
+namespace storage
+{
+
+    /**
+     * Simple pool with a bounded number of worker threads executing
+     * tasks. The threads are started when the first task is added.
+     *
+     * If a task throws an exception the first exception is rethrown by
+     * wait().
+     */
+    class ThreadPool : private boost::noncopyable
+    {
+    public:
+
+	typedef std::function<void()> task_t;
+
+	ThreadPool(unsigned int num_threads);
+
+	/**
+	 * Waits for all tasks to finish and stops the worker threads.
+	 */
+	~ThreadPool();
+
+	unsigned int get_num_threads() const { return num_threads; }
+
+	/**
+	 * Queue a task. May be called from within a task.
+	 */
+	void add_task(const task_t& task);
+
+	/**
+	 * Wait until all queued tasks are finished. Rethrows the first
+	 * exception thrown by a task.
+	 */
+	void wait();
+
+	/**
+	 * Convenience function to run the tasks with at most num_threads
+	 * threads and wait for them to finish.
+	 */
+	static void run(const std::vector<task_t>& tasks, unsigned int num_threads);
+
+    private:
+
+	void worker();
+
+	const unsigned int num_threads;
+
+	std::vector<std::thread> threads;
+
+	std::mutex mutex;
+	std::condition_variable task_available;
+	std::condition_variable tasks_done;
+
+	std::deque<task_t> tasks;
+	unsigned int num_running = 0;
+	bool stopping = false;
+
+	std::exception_ptr first_exception;
+
+    };
+
+
+    /**
+     * Lock to serialise tasks that run code that is not thread-safe. The
+     * lock is registered for the current thread and released by
+     * SerialLock::Release while the thread waits for something else,
+     * e.g. in SystemCmd for an external program. So only these waits run
+     * in parallel.
+     */
+    class SerialLock : private boost::noncopyable
+    {
+    public:
+
+	SerialLock(std::mutex& mutex);
+	~SerialLock();
+
+	/**
+	 * Releases the SerialLock of the current thread, if any, for the
+	 * lifetime of the object.
+	 */
+	class Release : private boost::noncopyable
+	{
+	public:
+
+	    Release();
+	    ~Release();
+
+	private:
+
+	    SerialLock* serial_lock;
+
+	};
+
+    private:
+
+	std::unique_lock<std::mutex> lock;
+
+	static thread_local SerialLock* current;
+
+    };
+
+}
+
+#endif
@@ -2,10 +2,15 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE libstorage
 
+#include "config.h"
+
+#include <unistd.h>
+#include <string.h>
 #include <boost/test/unit_test.hpp>
 #include <boost/algorithm/string.hpp>
 
 #include "storage/SystemInfo/CmdBlkid.h"
+#include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/StorageDefines.h"
 
@@ -207,3 +212,62 @@ BOOST_AUTO_TEST_CASE(parse_ddf)
 
     check(input, output);
 }
+
+
+#ifdef HAVE_LIBBLKID
+
+BOOST_AUTO_TEST_CASE(native1)
+{
+    // The device is probed without 'blkid' if libblkid is available but
+    // when recording the mockup key of the 'blkid' command is used and the
+    // recorded output can be played back. A swap signature in a file is
+    // used as device so that the test does not depend on the host.
+
+    char filename[] = "/tmp/blkid-native1-XXXXXX";
+    int fd = mkstemp(filename);
+    BOOST_REQUIRE(fd >= 0);
+
+    const size_t page_size = 4096;
+
+    vector<char> image(16 * page_size, 0);
+
+    // Swap header version 1: version, last page, number of bad pages,
+    // uuid and label.
+    const uint32_t header[3] = { 1, 15, 0 };
+    memcpy(&image[1024], header, sizeof(header));
+    const unsigned char uuid[16] = { 0x1c, 0x6c, 0x16, 0x7e, 0x2d, 0x59, 0x4a, 0x3d,
+				     0x8a, 0x4b, 0x94, 0x3f, 0x6a, 0x0e, 0x52, 0x37 };
+    memcpy(&image[1036], uuid, sizeof(uuid));
+    strcpy(&image[1052], "SWAP");
+    memcpy(&image[page_size - 10], "SWAPSPACE2", 10);
+
+    BOOST_REQUIRE_EQUAL(write(fd, image.data(), image.size()), (ssize_t) image.size());
+    close(fd);
+
+    const string cmd_line = BLKIDBIN " -c '/dev/null' " + quote(filename);
+
+    Mockup::set_mode(Mockup::Mode::RECORD);
+
+    Blkid blkid1(filename);
+
+    BOOST_CHECK(Mockup::has_command(cmd_line));
+
+    unlink(filename);
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    Blkid blkid2(filename);
+
+    ostringstream parsed1;
+    parsed1 << blkid1;
+
+    BOOST_CHECK_EQUAL(parsed1.str(), "data[" + string(filename) + "] -> is-fs:1 fs-type:swap "
+		      "fs-uuid:1c6c167e-2d59-4a3d-8a4b-943f6a0e5237 fs-label:SWAP\n");
+
+    ostringstream parsed2;
+    parsed2 << blkid2;
+
+    BOOST_CHECK_EQUAL(parsed1.str(), parsed2.str());
+}
+
+#endif
@@ -0,0 +1,53 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/SystemInfo/CmdDf.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/StorageDefines.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(parse1)
+{
+    vector<string> input = {
+	"     1B-blocks        Used       Avail Type",
+	"   42945478656  8929869824 33425592320 xfs"
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(DFBIN " --block-size=1 --output=size,used,avail,fstype '/test'", input);
+
+    CmdDf cmd_df("/test");
+
+    BOOST_CHECK_EQUAL(cmd_df.get_size(), 42945478656);
+    BOOST_CHECK_EQUAL(cmd_df.get_used(), 8929869824);
+}
+
+
+BOOST_AUTO_TEST_CASE(native1)
+{
+    // The filesystem is queried without 'df' but when recording the mockup
+    // key of the 'df' command is used and the recorded output can be
+    // played back.
+
+    Mockup::set_mode(Mockup::Mode::RECORD);
+
+    CmdDf cmd_df1(".");
+
+    BOOST_CHECK(cmd_df1.get_size() > 0);
+    BOOST_CHECK(Mockup::has_command(DFBIN " --block-size=1 --output=size,used,avail,fstype '.'"));
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    CmdDf cmd_df2(".");
+
+    BOOST_CHECK_EQUAL(cmd_df2.get_size(), cmd_df1.get_size());
+    BOOST_CHECK_EQUAL(cmd_df2.get_used(), cmd_df1.get_used());
+}
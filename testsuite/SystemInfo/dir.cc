@@ -2,6 +2,8 @@
 #define BOOST_TEST_DYN_LINK
 #define BOOST_TEST_MODULE libstorage
 
+#include <unistd.h>
+#include <fstream>
 #include <boost/test/unit_test.hpp>
 #include <boost/algorithm/string.hpp>
 
@@ -9,6 +11,7 @@
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/SystemCmd.h"
 #include "storage/Utils/StorageDefines.h"
+#include "storage/Utils/FileUtils.h"
 
 
 using namespace std;
@@ -61,3 +64,40 @@ BOOST_AUTO_TEST_CASE(error1)
 
     BOOST_CHECK_THROW(Dir dir(path), Exception);
 }
+
+
+BOOST_AUTO_TEST_CASE(native1)
+{
+    // The directory is read without 'ls' but when recording the mockup key
+    // of the 'ls' command is used.
+
+    TmpDir tmp_dir("dir-test-XXXXXX");
+    const string path = tmp_dir.get_fullname();
+
+    ofstream(path + "/sdb");
+    ofstream(path + "/sda");
+    ofstream(path + "/.hidden");
+
+    Mockup::set_mode(Mockup::Mode::RECORD);
+
+    Dir dir(path);
+
+    vector<string> entries(dir.begin(), dir.end());
+    sort(entries.begin(), entries.end());
+
+    BOOST_CHECK_EQUAL(boost::join(entries, " "), "sda sdb");
+
+    BOOST_CHECK(Mockup::has_command(LSBIN " -1 --sort=none " + quote(path)));
+
+    unlink((path + "/sda").c_str());
+    unlink((path + "/sdb").c_str());
+    unlink((path + "/.hidden").c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE(native_error1)
+{
+    Mockup::set_mode(Mockup::Mode::NONE);
+
+    BOOST_CHECK_THROW(Dir dir("/does-not-exist"), Exception);
+}
@@ -0,0 +1,58 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/SystemInfo/SystemInfo.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/StorageDefines.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+void
+set_subvolumes(const string& device, const vector<string>& paths)
+{
+    vector<string> lines;
+    for (size_t i = 0; i < paths.size(); ++i)
+	lines.push_back("ID " + to_string(256 + i) + " gen 8 parent 5 top level 5 path " + paths[i]);
+
+    Mockup::set_command(BTRFSBIN " subvolume list -a -p (device:" + device + ")", lines);
+}
+
+
+bool
+has_subvolume(SystemInfo& system_info, const string& device, const string& path)
+{
+    const CmdBtrfsSubvolumeList& cmd_btrfs_subvolume_list =
+	system_info.getCmdBtrfsSubvolumeList(device, "/does-not-matter");
+
+    return cmd_btrfs_subvolume_list.find_entry_by_path(path) != cmd_btrfs_subvolume_list.end();
+}
+
+
+BOOST_AUTO_TEST_CASE(invalidate)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    set_subvolumes("/dev/sda1", { "home" });
+    set_subvolumes("/dev/sdb1", { "srv" });
+
+    SystemInfo system_info;
+
+    BOOST_CHECK(has_subvolume(system_info, "/dev/sda1", "home"));
+    BOOST_CHECK(has_subvolume(system_info, "/dev/sdb1", "srv"));
+
+    set_subvolumes("/dev/sda1", { "home", "var" });
+    set_subvolumes("/dev/sdb1", { "srv", "tmp" });
+
+    // Only the information for /dev/sda1 is read again.
+
+    system_info.invalidate({ "/dev/sda", "/dev/sda1" });
+
+    BOOST_CHECK(has_subvolume(system_info, "/dev/sda1", "var"));
+    BOOST_CHECK(!has_subvolume(system_info, "/dev/sdb1", "tmp"));
+}
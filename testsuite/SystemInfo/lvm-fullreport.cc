@@ -0,0 +1,144 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/SystemInfo/CmdLvm.h"
+#include "storage/SystemInfo/SystemInfo.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/StorageDefines.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+const string fullreport_command = LVMBIN " fullreport --reportformat json --units b --nosuffix "
+    "--all --configreport pv --options pv_name,pv_uuid,vg_name,vg_uuid,pv_attr --configreport "
+    "vg --options vg_name,vg_uuid,vg_attr,vg_extent_size,vg_extent_count,vg_free_count "
+    "--configreport lv --options lv_name,lv_uuid,vg_name,vg_uuid,lv_role,lv_attr,lv_size,pool_lv,"
+    "pool_lv_uuid,data_lv,data_lv_uuid,metadata_lv,metadata_lv_uuid --configreport seg --options "
+    "lv_uuid,stripes,stripe_size,chunk_size --configreport pvseg --options pv_uuid";
+
+
+template <typename Type>
+string
+as_string(const Type& cmd)
+{
+    ostringstream parsed;
+    parsed.setf(std::ios::boolalpha);
+    parsed << cmd;
+    return parsed.str();
+}
+
+
+BOOST_AUTO_TEST_CASE(parse1)
+{
+    vector<string> input = {
+	"  {",
+	"      \"report\": [",
+	"          {",
+	"              \"vg\": [",
+	"                  {\"vg_name\":\"test\", \"vg_uuid\":\"1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw\", \"vg_attr\":\"wz--n-\", \"vg_extent_size\":\"4194304\", \"vg_extent_count\":\"1022\", \"vg_free_count\":\"971\"}",
+	"              ]",
+	"              ,",
+	"              \"pv\": [",
+	"                  {\"pv_name\":\"/dev/sdb1\", \"pv_uuid\":\"Dz2Mq5-7pVN-7hOi-1I2T-K1wp-Jpdy-36SV9s\", \"vg_name\":\"test\", \"vg_uuid\":\"1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw\", \"pv_attr\":\"a--\"},",
+	"                  {\"pv_name\":\"/dev/sda1\", \"pv_uuid\":\"2Rv3fF-LgxO-oPfE-1XVq-9Ow8-x0ly-OvAjuf\", \"vg_name\":\"test\", \"vg_uuid\":\"1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw\", \"pv_attr\":\"a--\"}",
+	"              ]",
+	"              ,",
+	"              \"lv\": [",
+	"                  {\"lv_name\":\"striped\", \"lv_uuid\":\"RECoSq-x9Hg-895X-PB4a-mowu-p4hJ-cSzmJi\", \"vg_name\":\"test\", \"vg_uuid\":\"1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw\", \"lv_role\":\"public\", \"lv_attr\":\"-wi-a-----\", \"lv_size\":\"209715200\", \"pool_lv\":\"\", \"pool_lv_uuid\":\"\", \"data_lv\":\"\", \"data_lv_uuid\":\"\", \"metadata_lv\":\"\", \"metadata_lv_uuid\":\"\"},",
+	"                  {\"lv_name\":\"linear\", \"lv_uuid\":\"dlSOFR-1IMP-RiWe-48Pl-3Qnb-WX5b-TVFjYW\", \"vg_name\":\"test\", \"vg_uuid\":\"1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw\", \"lv_role\":\"public\", \"lv_attr\":\"-wi-a-----\", \"lv_size\":\"4194304\", \"pool_lv\":\"\", \"pool_lv_uuid\":\"\", \"data_lv\":\"\", \"data_lv_uuid\":\"\", \"metadata_lv\":\"\", \"metadata_lv_uuid\":\"\"}",
+	"              ]",
+	"              ,",
+	"              \"pvseg\": [",
+	"                  {\"pv_uuid\":\"Dz2Mq5-7pVN-7hOi-1I2T-K1wp-Jpdy-36SV9s\"},",
+	"                  {\"pv_uuid\":\"2Rv3fF-LgxO-oPfE-1XVq-9Ow8-x0ly-OvAjuf\"}",
+	"              ]",
+	"              ,",
+	"              \"seg\": [",
+	"                  {\"lv_uuid\":\"RECoSq-x9Hg-895X-PB4a-mowu-p4hJ-cSzmJi\", \"stripes\":\"2\", \"stripe_size\":\"65536\", \"chunk_size\":\"0\"},",
+	"                  {\"lv_uuid\":\"RECoSq-x9Hg-895X-PB4a-mowu-p4hJ-cSzmJi\", \"stripes\":\"1\", \"stripe_size\":\"0\", \"chunk_size\":\"0\"},",
+	"                  {\"lv_uuid\":\"dlSOFR-1IMP-RiWe-48Pl-3Qnb-WX5b-TVFjYW\", \"stripes\":\"1\", \"stripe_size\":\"0\", \"chunk_size\":\"0\"}",
+	"              ]",
+	"          }",
+	"          ,",
+	"          {",
+	"              \"vg\": [",
+	"              ]",
+	"              ,",
+	"              \"pv\": [",
+	"                  {\"pv_name\":\"/dev/sdc\", \"pv_uuid\":\"qquP1O-WWoh-Ofas-Rbx0-y72T-0sNe-Wnyc33\", \"vg_name\":\"\", \"vg_uuid\":\"\", \"pv_attr\":\"---\"}",
+	"              ]",
+	"              ,",
+	"              \"lv\": [",
+	"              ]",
+	"              ,",
+	"              \"pvseg\": [",
+	"              ]",
+	"              ,",
+	"              \"seg\": [",
+	"              ]",
+	"          }",
+	"      ]",
+	"  }"
+    };
+
+    vector<string> output_pvs = {
+	"pv:{ pv-name:/dev/sda1 pv-uuid:2Rv3fF-LgxO-oPfE-1XVq-9Ow8-x0ly-OvAjuf vg-name:test vg-uuid:1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw }",
+	"pv:{ pv-name:/dev/sdb1 pv-uuid:Dz2Mq5-7pVN-7hOi-1I2T-K1wp-Jpdy-36SV9s vg-name:test vg-uuid:1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw }",
+	"pv:{ pv-name:/dev/sdc pv-uuid:qquP1O-WWoh-Ofas-Rbx0-y72T-0sNe-Wnyc33 vg-name: vg-uuid: }"
+    };
+
+    vector<string> output_vgs = {
+	"vg:{ vg-name:test vg-uuid:1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw extent-size:4194304 extent-count:1022 free-extent-count:971 }"
+    };
+
+    vector<string> output_lvs = {
+	"lv:{ lv-name:linear lv-uuid:dlSOFR-1IMP-RiWe-48Pl-3Qnb-WX5b-TVFjYW vg-name:test vg-uuid:1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw lv-type:normal active:true size:4194304 segments:<stripes:1> }",
+	"lv:{ lv-name:striped lv-uuid:RECoSq-x9Hg-895X-PB4a-mowu-p4hJ-cSzmJi vg-name:test vg-uuid:1b9W8v-TNjH-1ca2-bR2T-43mZ-n5h9-NDpxBw lv-type:normal active:true size:209715200 segments:<stripes:2 stripe-size:65536 stripes:1> }"
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(fullreport_command, input);
+
+    CmdLvmFullreport cmd_lvm_fullreport;
+
+    BOOST_CHECK_EQUAL(as_string(cmd_lvm_fullreport.get_cmd_pvs()), boost::join(output_pvs, "\n") + "\n");
+    BOOST_CHECK_EQUAL(as_string(cmd_lvm_fullreport.get_cmd_vgs()), boost::join(output_vgs, "\n") + "\n");
+    BOOST_CHECK_EQUAL(as_string(cmd_lvm_fullreport.get_cmd_lvs()), boost::join(output_lvs, "\n") + "\n");
+}
+
+
+BOOST_AUTO_TEST_CASE(fallback)
+{
+    // Without 'lvm fullreport' SystemInfo falls back to pvs.
+
+    vector<string> input = {
+	"  {",
+	"      \"report\": [",
+	"          {",
+	"              \"pv\": [",
+	"                  {\"pv_name\":\"/dev/sda2\", \"pv_uuid\":\"qquP1O-WWoh-Ofas-Rbx0-y72T-0sNe-Wnyc33\", \"vg_name\":\"system\", \"vg_uuid\":\"OMPzXF-m3am-1zIl-AVdQ-i5Wx-tmyN-cevmRn\", \"pv_attr\":\"a--\"}",
+	"              ]",
+	"          }",
+	"      ]",
+	"  }"
+    };
+
+    vector<string> output = {
+	"pv:{ pv-name:/dev/sda2 pv-uuid:qquP1O-WWoh-Ofas-Rbx0-y72T-0sNe-Wnyc33 vg-name:system vg-uuid:OMPzXF-m3am-1zIl-AVdQ-i5Wx-tmyN-cevmRn }"
+    };
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(fullreport_command, Mockup::Command({}, { "  Unknown command 'fullreport'." }, 1));
+    Mockup::set_command(PVSBIN " --reportformat json --units b --nosuffix --options pv_name,"
+			"pv_uuid,vg_name,vg_uuid,pv_attr", input);
+
+    SystemInfo system_info;
+
+    BOOST_CHECK_EQUAL(as_string(system_info.getCmdPvs()), boost::join(output, "\n") + "\n");
+}
@@ -9,7 +9,9 @@
 #include <boost/algorithm/string/split.hpp>
 
 #include "storage/SystemInfo/ProcMounts.h"
+#include "storage/SystemInfo/SystemInfo.h"
 #include "storage/Utils/Mockup.h"
+#include "storage/Utils/StorageDefines.h"
 #include <iostream>
 
 using namespace std;
@@ -137,3 +139,60 @@ BOOST_AUTO_TEST_CASE(parse2)
 
     check(input_mount, input_swap, output);
 }
+
+
+BOOST_AUTO_TEST_CASE(get_by_name_with_udev_db)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    vector<string> input_mount = {
+	"/dev/mapper/system-root / ext4 rw,relatime 0 0",
+	"/dev/sda1 /boot ext4 rw,relatime 0 0",
+	"tmpfs /tmp tmpfs rw 0 0"
+    };
+
+    vector<string> input_swap = {
+	"Filename				Type		Size	Used	Priority"
+    };
+
+    vector<string> input_udevadm = {
+	"P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1",
+	"N: sda1",
+	"E: MAJOR=8",
+	"E: MINOR=1",
+	"E: SUBSYSTEM=block",
+	"",
+	"P: /devices/virtual/block/dm-0",
+	"N: dm-0",
+	"S: mapper/system-root",
+	"S: system/root",
+	"E: MAJOR=254",
+	"E: MINOR=0",
+	"E: SUBSYSTEM=block",
+	""
+    };
+
+    Mockup::set_file("/proc/mounts", input_mount);
+    Mockup::set_file("/proc/swaps", input_swap);
+    Mockup::set_command(UDEVADMBIN_SETTLE, {});
+    Mockup::set_command(UDEVADMBIN " info --export-db", input_udevadm);
+
+    SystemInfo system_info;
+
+    const ProcMounts& proc_mounts = system_info.getProcMounts();
+
+    // the aliases are resolved using the udev database, no 'udevadm info'
+    // command is run
+
+    vector<const FstabEntry*> entries = proc_mounts.get_by_name("/dev/system/root", system_info);
+    BOOST_REQUIRE_EQUAL(entries.size(), 1);
+    BOOST_CHECK_EQUAL(entries[0]->get_mount_point(), "/");
+
+    entries = proc_mounts.get_by_name("/dev/dm-0", system_info);
+    BOOST_REQUIRE_EQUAL(entries.size(), 1);
+    BOOST_CHECK_EQUAL(entries[0]->get_mount_point(), "/");
+
+    entries = proc_mounts.get_by_name("/dev/sda1", system_info);
+    BOOST_REQUIRE_EQUAL(entries.size(), 1);
+    BOOST_CHECK_EQUAL(entries[0]->get_mount_point(), "/boot");
+}
@@ -0,0 +1,119 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <sys/sysmacros.h>
+#include <boost/test/unit_test.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/SystemInfo/CmdUdevadm.h"
+#include "storage/Utils/Mockup.h"
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/StorageDefines.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+const vector<string> input = {
+    "P: /devices/virtual/mem/null",
+    "N: null",
+    "E: DEVNAME=/dev/null",
+    "E: DEVPATH=/devices/virtual/mem/null",
+    "E: MAJOR=1",
+    "E: MINOR=3",
+    "E: SUBSYSTEM=mem",
+    "",
+    "P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda",
+    "N: sda",
+    "S: disk/by-id/ata-WDC_WD10EADS-00M2B0_WD-WCAV52321683",
+    "S: disk/by-path/pci-0000:00:1f.2-ata-1.0",
+    "E: DEVNAME=/dev/sda",
+    "E: DEVTYPE=disk",
+    "E: MAJOR=8",
+    "E: MINOR=0",
+    "E: SUBSYSTEM=block",
+    "",
+    "P: /devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1",
+    "N: sda1",
+    "S: disk/by-id/ata-WDC_WD10EADS-00M2B0_WD-WCAV52321683-part1",
+    "S: disk/by-path/pci-0000:00:1f.2-ata-1.0-part1",
+    "S: disk/by-uuid/14875716-b8e3-4c83-ac86-48c20682b63a",
+    "E: DEVNAME=/dev/sda1",
+    "E: DEVTYPE=partition",
+    "E: MAJOR=8",
+    "E: MINOR=1",
+    "E: SUBSYSTEM=block",
+    "",
+    "P: /devices/virtual/block/dm-0",
+    "N: dm-0",
+    "S: disk/by-id/dm-name-system-root",
+    "S: mapper/system-root",
+    "S: system/root",
+    "E: DEVNAME=/dev/dm-0",
+    "E: MAJOR=254",
+    "E: MINOR=0",
+    "E: SUBSYSTEM=block",
+    ""
+};
+
+
+BOOST_AUTO_TEST_CASE(parse1)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(UDEVADMBIN_SETTLE, {});
+    Mockup::set_command(UDEVADMBIN " info --export-db", input);
+
+    CmdUdevadmDb cmd_udevadm_db;
+
+    vector<string> output = {
+	"file:/dev/sda path:/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda name:sda majorminor:8:0 by-path-links:<pci-0000:00:1f.2-ata-1.0> by-id-links:<ata-WDC_WD10EADS-00M2B0_WD-WCAV52321683>",
+	"file:/dev/sda1 path:/devices/pci0000:00/0000:00:1f.2/ata1/host0/target0:0:0/0:0:0:0/block/sda/sda1 name:sda1 majorminor:8:1 by-path-links:<pci-0000:00:1f.2-ata-1.0-part1> by-id-links:<ata-WDC_WD10EADS-00M2B0_WD-WCAV52321683-part1>",
+	"file:/dev/dm-0 path:/devices/virtual/block/dm-0 name:dm-0 majorminor:254:0 by-id-links:<dm-name-system-root>"
+    };
+
+    ostringstream parsed;
+    parsed << cmd_udevadm_db;
+
+    BOOST_CHECK_EQUAL(parsed.str(), boost::join(output, "\n") + "\n");
+
+    BOOST_CHECK_EQUAL(cmd_udevadm_db.size(), 3);
+
+    BOOST_REQUIRE(cmd_udevadm_db.find_by_file("/dev/sda1"));
+    BOOST_CHECK_EQUAL(cmd_udevadm_db.find_by_file("/dev/sda1")->get_name(), "sda1");
+
+    BOOST_REQUIRE(cmd_udevadm_db.find_by_file("/dev/mapper/system-root"));
+    BOOST_CHECK_EQUAL(cmd_udevadm_db.find_by_file("/dev/mapper/system-root")->get_name(), "dm-0");
+
+    BOOST_REQUIRE(cmd_udevadm_db.find_by_file("/dev/system/root"));
+    BOOST_CHECK_EQUAL(cmd_udevadm_db.find_by_file("/dev/system/root")->get_major(), 254);
+
+    BOOST_REQUIRE(cmd_udevadm_db.find_by_majorminor(makedev(8, 0)));
+    BOOST_CHECK_EQUAL(cmd_udevadm_db.find_by_majorminor(makedev(8, 0))->get_name(), "sda");
+
+    BOOST_REQUIRE(cmd_udevadm_db.find_by_uuid("14875716-b8e3-4c83-ac86-48c20682b63a"));
+    BOOST_CHECK_EQUAL(cmd_udevadm_db.find_by_uuid("14875716-b8e3-4c83-ac86-48c20682b63a")->get_name(), "sda1");
+
+    BOOST_CHECK(!cmd_udevadm_db.find_by_file("/dev/null"));
+    BOOST_CHECK(!cmd_udevadm_db.find_by_file("/dev/sdb"));
+}
+
+
+BOOST_AUTO_TEST_CASE(info_from_db)
+{
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+    Mockup::set_command(UDEVADMBIN_SETTLE, {});
+    Mockup::set_command(UDEVADMBIN " info --export-db", input);
+
+    CmdUdevadmDb cmd_udevadm_db;
+
+    // no 'udevadm info' command is needed
+
+    CmdUdevadmInfo cmd_udevadm_info("/dev/mapper/system-root", &cmd_udevadm_db);
+
+    ostringstream parsed;
+    parsed << cmd_udevadm_info;
+
+    BOOST_CHECK_EQUAL(parsed.str(), "file:/dev/mapper/system-root path:/devices/virtual/block/dm-0 name:dm-0 "
+		      "majorminor:254:0 by-id-links:<dm-name-system-root>\n");
+}
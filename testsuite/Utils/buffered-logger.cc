@@ -0,0 +1,82 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <stdlib.h>
+#include <unistd.h>
+#include <fstream>
+#include <boost/algorithm/string.hpp>
+
+#include "storage/Utils/LoggerImpl.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+namespace
+{
+
+    vector<string>
+    read_lines(const string& filename)
+    {
+	vector<string> lines;
+
+	ifstream s(filename);
+	string line;
+	while (getline(s, line))
+	    lines.push_back(line);
+
+	return lines;
+    }
+
+}
+
+
+BOOST_AUTO_TEST_CASE(test_flush)
+{
+    char filename[] = "/tmp/buffered-logger-XXXXXX";
+    int fd = mkstemp(filename);
+    BOOST_REQUIRE(fd >= 0);
+    close(fd);
+
+    BufferedLogfileLogger logger(filename);
+
+    for (int i = 0; i < 100; ++i)
+	logger.write(LogLevel::MILESTONE, "libstorage", "test.cc", i, "test", "line " + to_string(i));
+
+    logger.flush();
+
+    vector<string> lines = read_lines(filename);
+
+    BOOST_REQUIRE_EQUAL(lines.size(), 100);
+    BOOST_CHECK(boost::ends_with(lines.front(), "test.cc(test):0 line 0"));
+    BOOST_CHECK(boost::ends_with(lines.back(), "test.cc(test):99 line 99"));
+
+    unlink(filename);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_stop)
+{
+    char filename[] = "/tmp/buffered-logger-XXXXXX";
+    int fd = mkstemp(filename);
+    BOOST_REQUIRE(fd >= 0);
+    close(fd);
+
+    BufferedLogfileLogger logger(filename);
+
+    logger.write(LogLevel::MILESTONE, "libstorage", "test.cc", 1, "test", "buffered");
+
+    logger.stop();
+
+    logger.write(LogLevel::MILESTONE, "libstorage", "test.cc", 2, "test", "direct");
+
+    vector<string> lines = read_lines(filename);
+
+    BOOST_REQUIRE_EQUAL(lines.size(), 2);
+    BOOST_CHECK(boost::ends_with(lines[0], "buffered"));
+    BOOST_CHECK(boost::ends_with(lines[1], "direct"));
+
+    unlink(filename);
+}
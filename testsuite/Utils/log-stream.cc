@@ -0,0 +1,60 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/LoggerImpl.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+namespace
+{
+
+    /**
+     * Logger that logs itself while writing a line.
+     */
+    class NestedLogger : public Logger
+    {
+    public:
+
+	virtual void write(LogLevel log_level, const string& component, const string& file,
+			   int line, const string& function, const string& content) override
+	{
+	    lines.push_back(content);
+
+	    if (!nested)
+	    {
+		nested = true;
+		y2mil("nested");
+		nested = false;
+	    }
+	}
+
+	vector<string> lines;
+
+    private:
+
+	bool nested = false;
+
+    };
+
+}
+
+
+BOOST_AUTO_TEST_CASE(test_nested)
+{
+    NestedLogger logger;
+    set_logger(&logger);
+
+    y2mil("first line\nsecond line");
+
+    set_logger(nullptr);
+
+    vector<string> expected = { "first line", "nested", "second line", "nested" };
+
+    BOOST_CHECK_EQUAL_COLLECTIONS(logger.lines.begin(), logger.lines.end(), expected.begin(),
+				  expected.end());
+}
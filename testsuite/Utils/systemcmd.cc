@@ -11,6 +11,7 @@
 #include <vector>
 
 #include "storage/Utils/Exception.h"
+#include "storage/Utils/JsonFile.h"
 #include "storage/Utils/Mockup.h"
 #include "storage/Utils/SystemCmd.h"
 
@@ -159,3 +160,97 @@ BOOST_AUTO_TEST_CASE(non_exec_throw)
     BOOST_CHECK_THROW({SystemCmd cmd( "/etc/fstab", SystemCmd::ThrowBehaviour::DoThrow);},
 		      SystemCmdException);
 }
+
+
+BOOST_AUTO_TEST_CASE(args_stdout)
+{
+    vector<string> stdout = {
+	"stdout #1: hello",
+	"stdout #2: it's me",
+	"stdout #3: $HOME"
+    };
+
+    SystemCmd cmd(vector<string>{ "../helpers/echoargs", "hello", "it's me", "$HOME" });
+
+    BOOST_CHECK_EQUAL(cmd.command(), "'../helpers/echoargs' 'hello' 'it'\\''s me' '$HOME'");
+    BOOST_CHECK_EQUAL(join(cmd.stdout()), join(stdout));
+    BOOST_CHECK(cmd.stderr().empty());
+    BOOST_CHECK(cmd.retcode() == 0);
+}
+
+
+BOOST_AUTO_TEST_CASE(args_pipe_stdin)
+{
+    vector<string> stdout = {
+        "Hello, cruel world",
+        "I'm leaving you today"
+    };
+
+    SystemCmd::Options cmd_options(vector<string>{ "cat" });
+    cmd_options.stdin_text = "Hello, cruel world\nI'm leaving you today";
+
+    SystemCmd cmd(cmd_options);
+
+    BOOST_CHECK_EQUAL(join(cmd.stdout()), join(stdout));
+}
+
+
+BOOST_AUTO_TEST_CASE(stdout_processor)
+{
+    // The output is large enough to be read in several chunks.
+
+    JsonFile json_file;
+
+    SystemCmd::Options cmd_options(vector<string>{ "awk", "BEGIN { printf \"{ \\\"values\\\": [\"; "
+	    "for (i = 0; i < 20000; i++) printf \"%s{ \\\"value\\\": \\\"%d\\\" }\", (i ? \", \" : \" \"), i; "
+	    "print \" ] }\" }" });
+    cmd_options.stdout_processor = &json_file;
+
+    SystemCmd cmd(cmd_options);
+
+    BOOST_CHECK(cmd.stdout().empty());
+    BOOST_CHECK(cmd.retcode() == 0);
+
+    vector<string> values;
+    BOOST_CHECK(for_each_child_node(json_file.get_root(), "values", [&values](json_object* object) {
+	string value;
+	get_child_value(object, "value", value);
+	values.push_back(value);
+    }));
+
+    BOOST_CHECK_EQUAL(values.size(), 20000);
+    BOOST_CHECK_EQUAL(values.back(), "19999");
+}
+
+
+BOOST_AUTO_TEST_CASE(args_retcode_42)
+{
+    SystemCmd cmd(vector<string>{ "../helpers/retcode", "42" });
+
+    BOOST_CHECK(cmd.retcode() == 42);
+}
+
+
+BOOST_AUTO_TEST_CASE(args_non_existent_no_throw)
+{
+    BOOST_CHECK_NO_THROW({
+	SystemCmd cmd(vector<string>{ "/bin/wrglbrmpf" }, SystemCmd::ThrowBehaviour::NoThrow);
+	BOOST_CHECK_EQUAL(cmd.retcode(), 127);
+    });
+}
+
+
+BOOST_AUTO_TEST_CASE(args_non_existent_throw)
+{
+    BOOST_CHECK_THROW({SystemCmd cmd(vector<string>{ "/bin/wrglbrmpf" }, SystemCmd::ThrowBehaviour::DoThrow);},
+		      CommandNotFoundException);
+}
+
+
+BOOST_AUTO_TEST_CASE(args_non_exec_no_throw)
+{
+    BOOST_CHECK_NO_THROW({
+	SystemCmd cmd(vector<string>{ "/etc/fstab" }, SystemCmd::ThrowBehaviour::NoThrow);
+	BOOST_CHECK_EQUAL(cmd.retcode(), 126);
+    });
+}
@@ -0,0 +1,106 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <atomic>
+#include <stdexcept>
+
+#include "storage/Utils/ThreadPool.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_run)
+{
+    atomic<int> sum(0);
+
+    vector<ThreadPool::task_t> tasks;
+    for (int i = 1; i <= 100; ++i)
+	tasks.push_back([&sum, i]() { sum += i; });
+
+    ThreadPool::run(tasks, 4);
+
+    BOOST_CHECK_EQUAL(sum, 5050);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_nested_add_task)
+{
+    atomic<int> count(0);
+
+    ThreadPool thread_pool(3);
+
+    for (int i = 0; i < 10; ++i)
+    {
+	thread_pool.add_task([&thread_pool, &count]() {
+	    ++count;
+	    thread_pool.add_task([&count]() { ++count; });
+	});
+    }
+
+    thread_pool.wait();
+
+    BOOST_CHECK_EQUAL(count, 20);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_exception)
+{
+    atomic<int> count(0);
+
+    ThreadPool thread_pool(2);
+
+    thread_pool.add_task([]() { throw runtime_error("failure"); });
+
+    for (int i = 0; i < 10; ++i)
+	thread_pool.add_task([&count]() { ++count; });
+
+    BOOST_CHECK_THROW(thread_pool.wait(), runtime_error);
+
+    // the other tasks are still executed
+    BOOST_CHECK_EQUAL(count, 10);
+
+    // the exception is only reported once
+    BOOST_CHECK_NO_THROW(thread_pool.wait());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_serial_lock)
+{
+    std::mutex mutex;
+
+    int inside = 0;
+    int max_inside = 0;
+    atomic<int> released(0);
+
+    vector<ThreadPool::task_t> tasks;
+    for (int i = 0; i < 4; ++i)
+    {
+	tasks.push_back([&]() {
+	    SerialLock lock(mutex);
+
+	    max_inside = max(max_inside, ++inside);
+
+	    {
+		--inside;
+
+		SerialLock::Release release;
+
+		// all tasks can get here at the same time
+		++released;
+		while (released < 4)
+		    this_thread::yield();
+	    }
+
+	    max_inside = max(max_inside, ++inside);
+	    --inside;
+	});
+    }
+
+    ThreadPool::run(tasks, 4);
+
+    BOOST_CHECK_EQUAL(released, 4);
+    BOOST_CHECK_EQUAL(max_inside, 1);
+}
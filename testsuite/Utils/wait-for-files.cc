@@ -0,0 +1,71 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <fstream>
+#include <thread>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "storage/Utils/FileUtils.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_existing)
+{
+    TmpDir tmp_dir("wait-for-files-XXXXXX");
+
+    const string name = tmp_dir.get_fullname() + "/a";
+    ofstream(name.c_str());
+
+    BOOST_CHECK(wait_for_files({ name }, chrono::milliseconds(0)).empty());
+
+    unlink(name.c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE(test_missing)
+{
+    TmpDir tmp_dir("wait-for-files-XXXXXX");
+
+    const string name = tmp_dir.get_fullname() + "/a";
+
+    const chrono::steady_clock::time_point start = chrono::steady_clock::now();
+
+    BOOST_CHECK_EQUAL(wait_for_files({ name }, chrono::milliseconds(100)).size(), 1);
+
+    BOOST_CHECK(chrono::steady_clock::now() - start >= chrono::milliseconds(100));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_created_later)
+{
+    // The second file is created in a subdirectory not existing when
+    // starting to wait.
+
+    TmpDir tmp_dir("wait-for-files-XXXXXX");
+
+    const string name1 = tmp_dir.get_fullname() + "/a";
+    const string dir = tmp_dir.get_fullname() + "/b";
+    const string name2 = dir + "/c";
+
+    thread creator([&]() {
+	this_thread::sleep_for(chrono::milliseconds(50));
+	ofstream(name1.c_str());
+	mkdir(dir.c_str(), 0700);
+	this_thread::sleep_for(chrono::milliseconds(50));
+	ofstream(name2.c_str());
+    });
+
+    BOOST_CHECK(wait_for_files({ name1, name2 }, chrono::seconds(10)).empty());
+
+    creator.join();
+
+    unlink(name2.c_str());
+    rmdir(dir.c_str());
+    unlink(name1.c_str());
+}
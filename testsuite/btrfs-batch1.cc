@@ -0,0 +1,84 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/Btrfs.h"
+#include "storage/Filesystems/BtrfsSubvolume.h"
+#include "storage/Filesystems/MountPoint.h"
+#include "storage/Devicegraph.h"
+#include "storage/Actiongraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/HumanString.h"
+#include "storage/Utils/Mockup.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(test_batch)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", 16 * GiB);
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 10000000, 512), PartitionType::PRIMARY);
+
+    Btrfs* btrfs = to_btrfs(sda1->create_blk_filesystem(FsType::BTRFS));
+
+    // The mount point avoids a temporary mount with unpredictable path.
+
+    btrfs->get_top_level_btrfs_subvolume()->create_mount_point("/tmp");
+
+    storage.remove_devicegraph("probed");
+    storage.copy_devicegraph("staging", "probed");
+
+    staging = storage.get_staging();
+    btrfs = to_btrfs(BlkDevice::find_by_name(staging, "/dev/sda1")->get_blk_filesystem());
+
+    BtrfsSubvolume* top_level = btrfs->get_top_level_btrfs_subvolume();
+
+    BtrfsSubvolume* home = top_level->create_btrfs_subvolume("home");
+    BtrfsSubvolume* srv = top_level->create_btrfs_subvolume("srv");
+    BtrfsSubvolume* var = top_level->create_btrfs_subvolume("var");
+    var->set_nocow(true);
+
+    const Actiongraph* actiongraph = storage.calculate_actiongraph();
+
+    BOOST_CHECK_EQUAL(actiongraph->get_commit_actions().size(), 4);
+
+    // All actions are committed with one subvolume list and one chattr
+    // run. Otherwise the mockup for the other runs would be missing.
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    Mockup::set_command("/sbin/btrfs subvolume create '/tmp/home'", vector<string>());
+    Mockup::set_command("/sbin/btrfs subvolume create '/tmp/srv'", vector<string>());
+    Mockup::set_command("/sbin/btrfs subvolume create '/tmp/var'", vector<string>());
+    Mockup::set_command("/usr/bin/chattr +C '/tmp/var'", vector<string>());
+    Mockup::set_command("/sbin/btrfs subvolume list -a -p (device:/dev/sda1)", vector<string>({
+	"ID 256 gen 8 parent 5 top level 5 path home",
+	"ID 257 gen 8 parent 5 top level 5 path srv",
+	"ID 258 gen 8 parent 5 top level 5 path var"
+    }));
+
+    BOOST_CHECK_NO_THROW(storage.commit(CommitOptions(false)));
+
+    BOOST_CHECK_EQUAL(home->get_id(), 256);
+    BOOST_CHECK_EQUAL(srv->get_id(), 257);
+    BOOST_CHECK_EQUAL(var->get_id(), 258);
+}
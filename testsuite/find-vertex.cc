@@ -6,6 +6,7 @@
 
 #include "storage/Devices/Disk.h"
 #include "storage/Devices/Partition.h"
+#include "storage/Devices/PartitionTable.h"
 #include "storage/Holders/Subdevice.h"
 #include "storage/Environment.h"
 #include "storage/Storage.h"
@@ -39,3 +40,106 @@ BOOST_AUTO_TEST_CASE(find_vertex)
     BOOST_CHECK(!sda->exists_in_probed());
     BOOST_CHECK(sda->exists_in_staging());
 }
+
+
+BOOST_AUTO_TEST_CASE(find_by_sid)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda", Region(0, 1000000, 512));
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 4096, 512), PartitionType::PRIMARY);
+    Partition* sda2 = gpt->create_partition("/dev/sda2", Region(6144, 4096, 512), PartitionType::PRIMARY);
+
+    sid_t gpt_sid = gpt->get_sid();
+    sid_t sda1_sid = sda1->get_sid();
+    sid_t sda2_sid = sda2->get_sid();
+
+    BOOST_CHECK_EQUAL(devicegraph->find_device(sda1_sid), sda1);
+    BOOST_CHECK(devicegraph->find_holder(gpt_sid, sda1_sid));
+    BOOST_CHECK_THROW(devicegraph->find_holder(sda1_sid, gpt_sid), HolderNotFoundBySids);
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_EQUAL(copy->find_device(sda1_sid)->get_sid(), sda1_sid);
+    BOOST_CHECK(copy->find_holder(gpt_sid, sda2_sid));
+
+    gpt->delete_partition(sda1);
+
+    BOOST_CHECK(!devicegraph->device_exists(sda1_sid));
+    BOOST_CHECK_THROW(devicegraph->find_device(sda1_sid), DeviceNotFoundBySid);
+    BOOST_CHECK_THROW(devicegraph->find_holder(gpt_sid, sda1_sid), HolderNotFoundBySids);
+    BOOST_CHECK(devicegraph->find_holder(gpt_sid, sda2_sid));
+
+    BOOST_CHECK(copy->device_exists(sda1_sid));
+
+    devicegraph->check();
+    copy->check();
+
+    copy->clear();
+
+    BOOST_CHECK(!copy->device_exists(gpt_sid));
+}
+
+
+BOOST_AUTO_TEST_CASE(find_by_name_after_rename)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb");
+
+    sda->set_name("/dev/sdc");
+
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sda"), DeviceNotFound);
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(devicegraph, "/dev/sdc"), sda);
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(devicegraph, "/dev/sdb"), sdb);
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_EQUAL(BlkDevice::find_by_name(copy, "/dev/sdc")->get_sid(), sda->get_sid());
+
+    devicegraph->remove_device(sdb);
+
+    BOOST_CHECK_THROW(BlkDevice::find_by_name(devicegraph, "/dev/sdb"), DeviceNotFound);
+    BOOST_CHECK(BlkDevice::find_by_name(copy, "/dev/sdb"));
+}
+
+
+BOOST_AUTO_TEST_CASE(vertex_index_after_remove)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    Disk* sda = Disk::create(devicegraph, "/dev/sda");
+    Disk* sdb = Disk::create(devicegraph, "/dev/sdb");
+
+    PartitionTable* gpt = sdb->create_partition_table(PtType::GPT);
+    Partition* sdb1 = gpt->create_partition("/dev/sdb1", Region(2048, 1000, 512), PartitionType::PRIMARY);
+
+    devicegraph->remove_device(sda);
+
+    BOOST_CHECK_NO_THROW(devicegraph->check());
+
+    BOOST_CHECK_EQUAL(sdb->get_descendants(false).size(), 2);
+    BOOST_CHECK_EQUAL(sdb1->get_ancestors(false).size(), 2);
+
+    Devicegraph* copy = storage.copy_devicegraph("staging", "copy");
+
+    BOOST_CHECK_NO_THROW(copy->check());
+
+    BOOST_CHECK(*copy == *devicegraph);
+}
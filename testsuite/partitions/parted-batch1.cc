@@ -0,0 +1,87 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devicegraph.h"
+#include "storage/Actiongraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Region.h"
+#include "storage/Utils/Mockup.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+void
+check(unsigned int num_threads)
+{
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", Region(0, 5860466688, 512));
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    gpt->create_partition("/dev/sda1", Region(2048, 2097152, 512), PartitionType::PRIMARY);
+
+    storage.remove_devicegraph("probed");
+    storage.copy_devicegraph("staging", "probed");
+
+    staging = storage.get_staging();
+    sda = Disk::find_by_name(staging, "/dev/sda");
+    gpt = sda->get_partition_table();
+
+    gpt->delete_partition(Partition::find_by_name(staging, "/dev/sda1"));
+
+    gpt->create_partition("/dev/sda1", Region(2048, 1048576, 512), PartitionType::PRIMARY);
+
+    Partition* sda2 = gpt->create_partition("/dev/sda2", Region(1050624, 1048576, 512),
+					    PartitionType::PRIMARY);
+    sda2->set_id(ID_LVM);
+
+    Partition* sda3 = gpt->create_partition("/dev/sda3", Region(2099200, 1048576, 512),
+					    PartitionType::PRIMARY);
+    sda3->set_id(ID_MICROSOFT_RESERVED);
+
+    const Actiongraph* actiongraph = storage.calculate_actiongraph();
+
+    BOOST_CHECK_EQUAL(actiongraph->get_commit_actions().size(), 6);
+
+    // All actions are committed with one parted run. Otherwise the
+    // mockup for the other parted runs would be missing. Every flag
+    // needs an explicit state since further commands follow.
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    Mockup::set_command("/sbin/udevadm settle --timeout=20", vector<string>());
+    Mockup::set_command("/usr/sbin/parted --script --wipesignatures '/dev/sda' rm 1 "
+			"unit s mkpart '\"\"' ext2 2048 1050623 unit s mkpart '\"\"' ext2 1050624 2099199 "
+			"unit s mkpart '\"\"' ext2 2099200 3147775 set 3 msftres on set 2 lvm on",
+			vector<string>());
+
+    BOOST_CHECK_NO_THROW(storage.commit(CommitOptions(false, num_threads)));
+}
+
+
+BOOST_AUTO_TEST_CASE(test_batch)
+{
+    check(1);
+}
+
+
+BOOST_AUTO_TEST_CASE(test_batch_parallel)
+{
+    check(4);
+}
@@ -0,0 +1,106 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <iostream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/Md.h"
+#include "storage/Devices/Encryption.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Devices/LvmLv.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/HumanString.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    // Each stack consists of two disks with one partition each, a RAID1
+    // on the partitions, a LUKS on the RAID and a volume group on the
+    // LUKS with four logical volumes with filesystems, so 18 devices.
+
+    const int n = 200;
+
+    vector<const Disk*> disks;
+    vector<const BlkFilesystem*> blk_filesystems;
+
+    for (int i = 0; i < n; ++i)
+    {
+	Md* md = Md::create(staging, "/dev/md" + to_string(i));
+	md->set_md_level(MdLevel::RAID1);
+
+	for (int j = 0; j < 2; ++j)
+	{
+	    string name = "/dev/disk" + to_string(i) + "-" + to_string(j);
+
+	    Disk* disk = Disk::create(staging, name);
+	    disks.push_back(disk);
+
+	    PartitionTable* partition_table = disk->create_partition_table(PtType::GPT);
+
+	    Partition* partition = partition_table->create_partition(name + "p1", Region(2048, 1000000, 512),
+								     PartitionType::PRIMARY);
+
+	    md->add_device(partition);
+	}
+
+	Encryption* encryption = md->create_encryption("cr-md" + to_string(i));
+
+	LvmVg* lvm_vg = LvmVg::create(staging, "vg" + to_string(i));
+	lvm_vg->add_lvm_pv(encryption);
+
+	for (int j = 0; j < 4; ++j)
+	{
+	    LvmLv* lvm_lv = lvm_vg->create_lvm_lv("lv" + to_string(j), LvType::NORMAL, 100 * MiB);
+	    blk_filesystems.push_back(lvm_lv->create_blk_filesystem(FsType::EXT4));
+	}
+    }
+
+    BOOST_CHECK_EQUAL(staging->num_devices(), 18 * n);
+
+    const int m = 10;
+
+    size_t num_descendants = 0;
+
+    Stopwatch stopwatch;
+
+    for (int i = 0; i < m; ++i)
+	for (const Disk* disk : disks)
+	    num_descendants += disk->get_descendants(false).size();
+
+    cout << m << " x descendants of " << disks.size() << " disks: " << stopwatch << endl;
+
+    size_t num_ancestors = 0;
+
+    Stopwatch stopwatch2;
+
+    for (int i = 0; i < m; ++i)
+	for (const BlkFilesystem* blk_filesystem : blk_filesystems)
+	    num_ancestors += blk_filesystem->get_ancestors(false).size();
+
+    cout << m << " x ancestors of " << blk_filesystems.size() << " filesystems: " << stopwatch2 << endl;
+
+    // Disk: partition table, partition, md, encryption, pv, vg, 4 lvs and
+    // 4 filesystems.
+    BOOST_CHECK_EQUAL(num_descendants, m * disks.size() * 14);
+
+    // Filesystem: lv, vg, pv, encryption, md and twice partition, partition
+    // table and disk.
+    BOOST_CHECK_EQUAL(num_ancestors, m * blk_filesystems.size() * 11);
+}
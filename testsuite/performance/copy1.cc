@@ -0,0 +1,63 @@
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <iostream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("original");
+
+    // Each disk adds a partition table, four partitions and four
+    // filesystems, so 10 devices.
+
+    const int n = 1000;
+
+    for (int i = 0; i < n; ++i)
+    {
+	Disk* disk = Disk::create(devicegraph, "/dev/disk" + to_string(i));
+
+	PartitionTable* partition_table = disk->create_partition_table(PtType::GPT);
+
+	for (int j = 1; j < 5; ++j)
+	{
+	    Partition* partition = partition_table->create_partition("/dev/disk" + to_string(i) + "p" +
+								     to_string(j), Region(1000 * j, 1000, 512),
+								     PartitionType::PRIMARY);
+	    partition->create_blk_filesystem(FsType::EXT4);
+	}
+    }
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), 10 * n);
+
+    Devicegraph* copy = storage.create_devicegraph("copy");
+
+    const int m = 20;
+
+    Stopwatch stopwatch;
+
+    for (int i = 0; i < m; ++i)
+	devicegraph->copy(*copy);
+
+    cout << m << " x copy of " << devicegraph->num_devices() << " devices: " << stopwatch << endl;
+
+    BOOST_CHECK(*copy == *devicegraph);
+}
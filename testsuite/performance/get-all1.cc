@@ -0,0 +1,99 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <iostream>
+#include <sstream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/PartitionTable.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Devices/LvmVg.h"
+#include "storage/Filesystems/BlkFilesystem.h"
+#include "storage/Devicegraph.h"
+#include "storage/Storage.h"
+#include "storage/Environment.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+string
+disk_name(int i)
+{
+    ostringstream s;
+    s << "/dev/disk" << i;
+    return s.str();
+}
+
+
+string
+partition_name(int i, int j)
+{
+    ostringstream s;
+    s << "/dev/disk" << i << "p" << j;
+    return s.str();
+}
+
+
+void
+add_disk(Devicegraph* devicegraph, int i)
+{
+    Disk* disk = Disk::create(devicegraph, disk_name(i), Region(0, 1000000, 512));
+
+    PartitionTable* partition_table = disk->create_partition_table(PtType::GPT);
+
+    for (int j = 1; j < 5; ++j)
+    {
+	Partition* partition = partition_table->create_partition(partition_name(i, j),
+								 Region(10000 * j, 10000, 512),
+								 PartitionType::PRIMARY);
+	partition->create_blk_filesystem(FsType::EXT4);
+    }
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.get_staging();
+
+    const int n = 1000;
+
+    for (int i = 0; i < n; ++i)
+	add_disk(devicegraph, i);
+
+    LvmVg::create(devicegraph, "system");
+
+    BOOST_CHECK_EQUAL(devicegraph->num_devices(), 10 * n + 1);
+
+    const Devicegraph* tmp = devicegraph;
+
+    Stopwatch stopwatch;
+
+    // The LVM VG is a single device among thousands, so with per-type
+    // buckets the lookup does not depend on the number of disks.
+
+    const int m = 10000;
+
+    for (int i = 0; i < m; ++i)
+	BOOST_CHECK_EQUAL(tmp->get_all_lvm_vgs().size(), 1);
+
+    cout << m << " x get_all_lvm_vgs: " << stopwatch << endl;
+
+    Stopwatch stopwatch2;
+
+    for (int i = 0; i < 100; ++i)
+    {
+	BOOST_CHECK_EQUAL(tmp->get_all_disks().size(), n);
+	BOOST_CHECK_EQUAL(tmp->get_all_blk_filesystems().size(), 4 * n);
+    }
+
+    cout << "100 x get_all_disks and get_all_blk_filesystems: " << stopwatch2 << endl;
+}
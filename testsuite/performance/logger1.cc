@@ -0,0 +1,72 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <iostream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/LoggerImpl.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+class CountingLogger : public Logger
+{
+public:
+
+    virtual void write(LogLevel log_level, const string& component, const string& file, int line,
+		       const string& function, const string& content) override
+    {
+	++count;
+	size += content.size();
+    }
+
+    unsigned long count = 0;
+    unsigned long size = 0;
+
+};
+
+
+template <typename Func>
+double
+statements_per_second(int n, Func func)
+{
+    Stopwatch stopwatch;
+
+    for (int i = 0; i < n; ++i)
+	func(i);
+
+    return n / stopwatch.read();
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    CountingLogger logger;
+    set_logger(&logger);
+
+    const int n = 200000;
+
+    double enabled = statements_per_second(n, [](int i) {
+	y2mil("some text " << i << " more text " << true);
+    });
+
+    double multiline = statements_per_second(n, [](int i) {
+	y2mil("first line " << i << "\nsecond line");
+    });
+
+    double disabled = statements_per_second(n, [](int i) {
+	y2deb("some text " << i << " more text " << true);
+    });
+
+    set_logger(nullptr);
+
+    BOOST_CHECK_EQUAL(logger.count, 3 * n);
+
+    cout << "enabled: " << enabled << " statements/s" << endl;
+    cout << "multiline: " << multiline << " statements/s" << endl;
+    cout << "disabled: " << disabled << " statements/s" << endl;
+}
@@ -0,0 +1,43 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <iostream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Utils/SystemCmd.h"
+#include "storage/Utils/Stopwatch.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+template <typename Func>
+double
+commands_per_second(int n, Func func)
+{
+    Stopwatch stopwatch;
+
+    for (int i = 0; i < n; ++i)
+	func();
+
+    return n / stopwatch.read();
+}
+
+
+BOOST_AUTO_TEST_CASE(performance)
+{
+    const int n = 200;
+
+    double shell = commands_per_second(n, []() {
+	SystemCmd cmd("/bin/true", SystemCmd::DoThrow);
+    });
+
+    double args = commands_per_second(n, []() {
+	SystemCmd cmd(vector<string>{ "/bin/true" }, SystemCmd::DoThrow);
+    });
+
+    cout << "shell: " << shell << " commands/s" << endl;
+    cout << "args: " << args << " commands/s" << endl;
+}
@@ -0,0 +1,110 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <boost/test/unit_test.hpp>
+#include <unistd.h>
+
+#include "storage/Devices/Disk.h"
+#include "storage/Devices/Gpt.h"
+#include "storage/Devices/Partition.h"
+#include "storage/Filesystems/Ext4.h"
+#include "storage/SystemInfo/Arch.h"
+#include "storage/Utils/FileUtils.h"
+#include "storage/Utils/HumanString.h"
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/Devicegraph.h"
+#include "storage/ProbeCache.h"
+#include "storage/Utils/Mockup.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(save_and_load)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Devicegraph* staging = storage.get_staging();
+
+    Disk* sda = Disk::create(staging, "/dev/sda", 16 * GiB);
+
+    PartitionTable* gpt = sda->create_partition_table(PtType::GPT);
+
+    Partition* sda1 = gpt->create_partition("/dev/sda1", Region(2048, 10000000, 512), PartitionType::PRIMARY);
+    sda1->create_blk_filesystem(FsType::EXT4);
+
+    Arch arch(false);
+    arch.set_arch("s390x");
+
+    TmpDir tmp_dir("probe-cache-XXXXXX");
+    const string filename = tmp_dir.get_fullname() + "/cache.xml";
+
+    ProbeCache(filename).save(staging, arch);
+
+    Devicegraph* loaded = storage.create_devicegraph("loaded");
+    Arch loaded_arch(false);
+
+    BOOST_CHECK(ProbeCache(filename).load(loaded, loaded_arch));
+
+    BOOST_CHECK(*loaded == *staging);
+    BOOST_CHECK_EQUAL(loaded_arch.get_arch(), "s390x");
+
+    unlink(filename.c_str());
+    unlink((filename + ".key").c_str());
+}
+
+
+BOOST_AUTO_TEST_CASE(missing)
+{
+    Environment environment(true, ProbeMode::NONE, TargetMode::DIRECT);
+
+    Storage storage(environment);
+
+    Arch arch(false);
+
+    BOOST_CHECK(!ProbeCache("/does-not-exist/cache.xml").load(storage.get_staging(), arch));
+}
+
+
+BOOST_AUTO_TEST_CASE(invalidated_by_commit)
+{
+    TmpDir tmp_dir("probe-cache-XXXXXX");
+    const string filename = tmp_dir.get_fullname() + "/cache.xml";
+
+    Environment environment(true, ProbeMode::STANDARD, TargetMode::DIRECT);
+    environment.set_probe_cache_filename(filename);
+
+    Storage storage(environment);
+
+    Devicegraph* devicegraph = storage.create_devicegraph("cached");
+    Disk::create(devicegraph, "/dev/sda", 16 * GiB);
+
+    ProbeCache(filename).save(devicegraph, Arch(false));
+
+    // In playback mode without any commands probing the system fails.
+    // So the first probe succeeds only by loading the cache.
+
+    Mockup::set_mode(Mockup::Mode::PLAYBACK);
+
+    BOOST_CHECK_NO_THROW(storage.probe());
+    BOOST_CHECK(*storage.get_probed() == *devicegraph);
+
+    // Some actions, e.g. creating btrfs subvolumes, do not change the
+    // key of the cache. So every commit must invalidate the cache.
+
+    storage.calculate_actiongraph();
+    storage.commit();
+
+    BOOST_CHECK(access((filename + ".key").c_str(), F_OK) != 0);
+
+    BOOST_CHECK_THROW(storage.probe(), Exception);
+
+    Mockup::set_mode(Mockup::Mode::NONE);
+
+    unlink(filename.c_str());
+}
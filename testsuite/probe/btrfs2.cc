@@ -0,0 +1,45 @@
+
+#define BOOST_TEST_DYN_LINK
+#define BOOST_TEST_MODULE libstorage
+
+#include <iostream>
+#include <boost/test/unit_test.hpp>
+
+#include "storage/Environment.h"
+#include "storage/Storage.h"
+#include "storage/DevicegraphImpl.h"
+#include "storage/UsedFeatures.h"
+
+#include "testsuite/helpers/TsCmp.h"
+
+
+using namespace std;
+using namespace storage;
+
+
+BOOST_AUTO_TEST_CASE(probe)
+{
+    // /proc/mounts contains a temporary mount of the top-level subvolume,
+    // e.g. by EnsureMounted when btrfs is the first filesystem probed. It
+    // must not show up as mount point.
+
+    set_logger(get_stdout_logger());
+
+    Environment environment(true, ProbeMode::READ_MOCKUP, TargetMode::DIRECT);
+    environment.set_mockup_filename("btrfs2-mockup.xml");
+
+    Storage storage(environment);
+    storage.probe();
+
+    const Devicegraph* probed = storage.get_probed();
+    probed->check();
+
+    Devicegraph* staging = storage.get_staging();
+    staging->load("btrfs1-devicegraph.xml");
+    staging->check();
+
+    TsCmpDevicegraph cmp(*probed, *staging);
+    BOOST_CHECK_MESSAGE(cmp.ok(), cmp);
+
+    BOOST_CHECK_BITWISE_EQUAL(probed->used_features(), UF_BTRFS | UF_SWAP);
+}
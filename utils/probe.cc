@@ -19,6 +19,7 @@ bool display_devicegraph = false;
 bool save_devicegraph = false;
 bool save_mockup = false;
 bool load_mockup = false;
+string probe_cache;
 
 
 void
@@ -35,6 +36,7 @@ doit()
     Environment environment(true, probe_mode, TargetMode::DIRECT);
 
     environment.set_mockup_filename("mockup.xml");
+    environment.set_probe_cache_filename(probe_cache);
 
     Storage storage(environment);
     storage.probe();
@@ -71,7 +73,8 @@ void usage() __attribute__ ((__noreturn__));
 void
 usage()
 {
-    cerr << "probe [--display-devicegraph] [--save-devicegraph] [--save-mockup] [--load-mockup]\n";
+    cerr << "probe [--display-devicegraph] [--save-devicegraph] [--save-mockup] [--load-mockup] "
+	"[--probe-cache filename]\n";
     exit(EXIT_FAILURE);
 }
 
@@ -84,6 +87,7 @@ main(int argc, char **argv)
 	{ "save-devicegraph",		no_argument,	0,	2 },
 	{ "save-mockup",		no_argument,	0,	3 },
 	{ "load-mockup",		no_argument,	0,	4 },
+	{ "probe-cache",		required_argument,	0,	5 },
 	{ 0, 0, 0, 0 }
     };
 
@@ -115,6 +119,10 @@ main(int argc, char **argv)
 		load_mockup = true;
 		break;
 
+	    case 5:
+		probe_cache = optarg;
+		break;
+
 	    default:
 		usage();
 	}